@@ -0,0 +1,144 @@
+#include "bimap.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<int> shuffled_keys(std::size_t count, unsigned seed) {
+  std::vector<int> res(count);
+  std::iota(res.begin(), res.end(), 0);
+  std::shuffle(res.begin(), res.end(), std::mt19937(seed));
+  return res;
+}
+
+void set_items(benchmark::State& state) {
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+
+void insert_random(benchmark::State& state) {
+  const auto lefts = shuffled_keys(state.range(0), 1);
+  const auto rights = shuffled_keys(state.range(0), 2);
+  for (auto _ : state) {
+    bimap<int, int> b;
+    for (std::size_t i = 0; i < lefts.size(); ++i) {
+      b.insert(lefts[i], rights[i]);
+    }
+    benchmark::DoNotOptimize(b.size());
+  }
+  set_items(state);
+}
+
+void insert_sorted(benchmark::State& state) {
+  const auto count = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    bimap<int, int> b;
+    for (int i = 0; i < count; ++i) {
+      b.insert(i, count - i);
+    }
+    benchmark::DoNotOptimize(b.size());
+  }
+  set_items(state);
+}
+
+void erase_random(benchmark::State& state) {
+  const auto lefts = shuffled_keys(state.range(0), 1);
+  const auto order = shuffled_keys(state.range(0), 3);
+  for (auto _ : state) {
+    state.PauseTiming();
+    bimap<int, int> b;
+    for (int left : lefts) {
+      b.insert(left, left);
+    }
+    state.ResumeTiming();
+    for (int left : order) {
+      b.erase_left(left);
+    }
+    benchmark::DoNotOptimize(b.size());
+  }
+  set_items(state);
+}
+
+// Steady state of a map that keeps its size: every step erases a random present pair and inserts a new one.
+void churn(benchmark::State& state) {
+  const auto count = static_cast<int>(state.range(0));
+  std::mt19937 rng(4);
+  std::vector<int> live(count);
+  std::iota(live.begin(), live.end(), 0);
+  bimap<int, int> b;
+  for (int key : live) {
+    b.insert(key, key);
+  }
+  int next = count;
+  for (auto _ : state) {
+    for (int i = 0; i < count; ++i) {
+      int& key = live[rng() % live.size()];
+      b.erase_left(key);
+      key = next++;
+      b.insert(key, key);
+    }
+  }
+  if (b.size() != live.size()) {
+    state.SkipWithError("churn changed the size of the map");
+  }
+  set_items(state);
+}
+
+void find_random(benchmark::State& state) {
+  const auto lefts = shuffled_keys(state.range(0), 1);
+  bimap<int, int> b;
+  for (int left : lefts) {
+    b.insert(left, left);
+  }
+  const auto order = shuffled_keys(state.range(0), 5);
+  for (auto _ : state) {
+    for (int left : order) {
+      benchmark::DoNotOptimize(b.find_left(left));
+    }
+  }
+  set_items(state);
+}
+
+void copy(benchmark::State& state) {
+  const auto lefts = shuffled_keys(state.range(0), 1);
+  const auto rights = shuffled_keys(state.range(0), 2);
+  bimap<int, int> b;
+  for (std::size_t i = 0; i < lefts.size(); ++i) {
+    b.insert(lefts[i], rights[i]);
+  }
+  for (auto _ : state) {
+    bimap<int, int> copy = b;
+    benchmark::DoNotOptimize(copy.size());
+  }
+  set_items(state);
+}
+
+void range_constructor(benchmark::State& state) {
+  const auto rights = shuffled_keys(state.range(0), 2);
+  std::vector<std::pair<int, int>> pairs;
+  for (std::size_t i = 0; i < rights.size(); ++i) {
+    pairs.emplace_back(static_cast<int>(i), rights[i]);
+  }
+  for (auto _ : state) {
+    bimap<int, int> b(pairs.begin(), pairs.end());
+    benchmark::DoNotOptimize(b.size());
+  }
+  set_items(state);
+}
+
+} // namespace
+
+BENCHMARK(insert_random)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+BENCHMARK(insert_sorted)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+BENCHMARK(erase_random)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+BENCHMARK(churn)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+BENCHMARK(find_random)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+BENCHMARK(copy)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+BENCHMARK(range_constructor)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_MAIN();
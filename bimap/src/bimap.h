@@ -2,17 +2,27 @@
 
 #include "bimap_details.h"
 #include "bst.h"
+#include "node_pool.h"
 
+#include <algorithm>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <ranges>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 template <
     typename Left,
     typename Right,
     typename CompareLeft = std::less<Left>,
-    typename CompareRight = std::less<Right>>
+    typename CompareRight = std::less<Right>,
+    typename Allocator = std::allocator<std::pair<Left, Right>>>
 class bimap {
   using left_tag = details::left_tag;
   using right_tag = details::right_tag;
@@ -22,63 +32,124 @@ class bimap {
 
   using node_t = details::node_with_value<Left, Right>;
   using sent_t = details::node_base;
+  using pool_t = details::node_pool<node_t, Allocator>;
 
   using iterator = details::bimap_iterator<Left, Right, CompareLeft, CompareRight>;
+  using alloc_traits = std::allocator_traits<Allocator>;
 
 public:
   using left_t = Left;
   using right_t = Right;
+  using allocator_type = Allocator;
 
   using left_iterator = typename iterator::left_iterator;
   using right_iterator = typename iterator::right_iterator;
 
-  bimap(CompareLeft compare_left = CompareLeft(), CompareRight compare_right = CompareRight())
+  bimap(
+      CompareLeft compare_left = CompareLeft(),
+      CompareRight compare_right = CompareRight(),
+      const Allocator& alloc = Allocator()
+  )
       : left_(static_cast<bst_element_left*>(&sent_), std::move(compare_left))
-      , right_(static_cast<bst_element_right*>(&sent_), std::move(compare_right)) {}
+      , right_(static_cast<bst_element_right*>(&sent_), std::move(compare_right))
+      , pool_(alloc) {}
+
+  explicit bimap(const Allocator& alloc)
+      : bimap(CompareLeft(), CompareRight(), alloc) {}
+
+  template <std::input_iterator It>
+  bimap(
+      It first,
+      It last,
+      CompareLeft compare_left = CompareLeft(),
+      CompareRight compare_right = CompareRight(),
+      const Allocator& alloc = Allocator()
+  )
+      : bimap(std::move(compare_left), std::move(compare_right), alloc) {
+    insert(first, last);
+  }
 
   bimap(const bimap& other)
-      : bimap(other.left_.get_comparator(), other.right_.get_comparator()) {
-    for (auto it = other.begin_left(); it != other.end_left(); ++it) {
-      insert(*it, *it.flip());
-    }
+      : bimap(
+            other.left_.get_comparator(),
+            other.right_.get_comparator(),
+            alloc_traits::select_on_container_copy_construction(other.get_allocator())
+        ) {
+    clone(other);
   }
 
   bimap(bimap&& other) noexcept
       : sent_(std::move(other.sent_))
       , left_(static_cast<bst_element_left*>(&sent_), std::move(other.left_))
       , right_(static_cast<bst_element_right*>(&sent_), std::move(other.right_))
-      , size_(std::exchange(other.size_, 0)) {}
+      , size_(std::exchange(other.size_, 0))
+      , pool_(std::move(other.pool_)) {}
 
   bimap& operator=(const bimap& other) {
     if (this != &other) {
-      bimap copy(other);
-      swap(*this, copy);
+      constexpr bool propagate = alloc_traits::propagate_on_container_copy_assignment::value;
+      bimap copy(
+          other.left_.get_comparator(),
+          other.right_.get_comparator(),
+          propagate ? other.get_allocator() : get_allocator()
+      );
+      copy.clone(other);
+      swap_contents<propagate>(copy);
     }
     return *this;
   }
 
-  bimap& operator=(bimap&& other) noexcept {
-    if (this != &other) {
-      clear();
-      swap(*this, other);
+  // With allocators that neither propagate nor compare equal, the pairs are moved one by one into nodes from
+  // this bimap's allocator, and `other` is left empty.
+  bimap& operator=(bimap&& other) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value
+  ) {
+    if (this == &other) {
+      return *this;
+    }
+    constexpr bool propagate = alloc_traits::propagate_on_container_move_assignment::value;
+    if constexpr (!propagate && !alloc_traits::is_always_equal::value) {
+      if (!pool_.same_allocator(other.pool_)) {
+        bimap moved(other.left_.get_comparator(), other.right_.get_comparator(), get_allocator());
+        try {
+          moved.clone(std::move(other));
+        } catch (...) {
+          // Some of its pairs may be moved from already.
+          other.clear();
+          throw;
+        }
+        other.clear();
+        swap_contents<false>(moved);
+        return *this;
+      }
     }
+    clear();
+    swap_contents<propagate>(other);
     return *this;
   }
 
   void clear() noexcept {
-    erase_left(begin_left(), end_left());
+    right_.detach_all();
+    if constexpr (std::is_trivially_destructible_v<node_t>) {
+      left_.detach_all();
+    } else {
+      left_.clear([this](node_t& node) { destroy_node(&node); });
+    }
+    size_ = 0;
+    pool_.release();
+  }
+
+  allocator_type get_allocator() const noexcept {
+    return pool_.get_allocator();
   }
 
   ~bimap() noexcept {
     clear();
   }
 
+  // Follows `propagate_on_container_swap`: unless it is set, the allocators must compare equal.
   friend void swap(bimap& lhs, bimap& rhs) noexcept {
-    using std::swap;
-    swap(lhs.sent_, rhs.sent_);
-    swap(lhs.left_, rhs.left_);
-    swap(lhs.right_, rhs.right_);
-    swap(lhs.size_, rhs.size_);
+    lhs.swap_contents<alloc_traits::propagate_on_container_swap::value>(rhs);
   }
 
   left_iterator insert(const left_t& left, const right_t& right) {
@@ -97,7 +168,106 @@ public:
     return insert_impl(std::move(left), std::move(right));
   }
 
+  // Same as inserting the pairs one by one in order. Into an empty bimap, pairs without repeated keys are linked
+  // in O(n) if sorted by left key and O(n log n) otherwise, instead of two tree searches and rebalances each.
+  template <std::input_iterator It>
+  void insert(It first, It last) {
+    if (!empty()) {
+      for (; first != last; ++first) {
+        auto&& pair = *first;
+        insert(std::get<0>(std::forward<decltype(pair)>(pair)), std::get<1>(std::forward<decltype(pair)>(pair)));
+      }
+      return;
+    }
+
+    std::vector<node_t*> nodes;
+    if constexpr (std::forward_iterator<It>) {
+      nodes.reserve(std::distance(first, last));
+    }
+    try {
+      for (; first != last; ++first) {
+        auto&& pair = *first;
+        if (nodes.size() == nodes.capacity()) {
+          nodes.reserve(2 * nodes.size() + 1);
+        }
+        nodes.push_back(create_node(
+            std::get<0>(std::forward<decltype(pair)>(pair)),
+            std::get<1>(std::forward<decltype(pair)>(pair))
+        ));
+      }
+    } catch (...) {
+      for (node_t* node : nodes) {
+        destroy_node(node);
+      }
+      throw;
+    }
+    link_nodes(nodes);
+  }
+
 private:
+  // Takes ownership of `nodes`, given in insertion order, and links them into the empty trees.
+  void link_nodes(const std::vector<node_t*>& nodes) {
+    auto less_left = [this](const node_t* lhs, const node_t* rhs) {
+      return left_.compare(lhs->get_left(), rhs->get_left());
+    };
+    auto less_right = [this](const node_t* lhs, const node_t* rhs) {
+      return right_.compare(lhs->get_right(), rhs->get_right());
+    };
+    try {
+      std::vector<node_t*> left_nodes(nodes);
+      std::vector<node_t*> right_nodes(nodes);
+      if (!std::is_sorted(left_nodes.begin(), left_nodes.end(), less_left)) {
+        std::sort(left_nodes.begin(), left_nodes.end(), less_left);
+      }
+      std::sort(right_nodes.begin(), right_nodes.end(), less_right);
+
+      auto same_left = [&](const node_t* lhs, const node_t* rhs) { return !less_left(lhs, rhs); };
+      auto same_right = [&](const node_t* lhs, const node_t* rhs) { return !less_right(lhs, rhs); };
+      if (std::adjacent_find(left_nodes.begin(), left_nodes.end(), same_left) == left_nodes.end() &&
+          std::adjacent_find(right_nodes.begin(), right_nodes.end(), same_right) == right_nodes.end()) {
+        left_.assign_sorted(left_nodes.begin(), left_nodes.end());
+        right_.assign_sorted(right_nodes.begin(), right_nodes.end());
+        size_ = nodes.size();
+        return;
+      }
+    } catch (...) {
+      for (node_t* node : nodes) {
+        destroy_node(node);
+      }
+      throw;
+    }
+
+    // Repeated keys: whether a pair is kept depends on which of the earlier ones were, so go one by one.
+    std::size_t i = 0;
+    try {
+      for (; i < nodes.size(); ++i) {
+        if (!link_node(nodes[i])) {
+          destroy_node(nodes[i]);
+        }
+      }
+    } catch (...) {
+      for (; i < nodes.size(); ++i) {
+        destroy_node(nodes[i]);
+      }
+      throw;
+    }
+  }
+
+  bool link_node(node_t* node) {
+    auto left_pos = left_.find_position(*node);
+    if (left_pos.inserted()) {
+      return false;
+    }
+    auto right_pos = right_.find_position(*node);
+    if (right_pos.inserted()) {
+      return false;
+    }
+    right_.insert(right_pos, *node);
+    left_.insert(left_pos, *node);
+    size_++;
+    return true;
+  }
+
   template <typename L, typename R>
   left_iterator insert_impl(L&& left, R&& right) {
     auto left_pos = left_.find_position(left);
@@ -111,7 +281,7 @@ private:
     if (right_pos.inserted()) {
       return end_left();
     }
-    auto* new_node = new node_t(std::forward<L>(left), std::forward<R>(right));
+    node_t* new_node = create_node(std::forward<L>(left), std::forward<R>(right));
     right_.insert(right_pos, *new_node);
     size_++;
     return left_.insert(left_pos, *new_node);
@@ -125,7 +295,7 @@ public:
 
     right_.erase(it.flip());
     left_iterator res = left_.erase(it);
-    delete it.get_node();
+    destroy_node(it.get_node());
     size_--;
     return res;
   }
@@ -136,7 +306,7 @@ public:
     }
     left_.erase(it.flip());
     right_iterator res = right_.erase(it);
-    delete it.get_node();
+    destroy_node(it.get_node());
     size_--;
     return res;
   }
@@ -211,13 +381,13 @@ public:
     auto left_it = right_it.flip();
     auto left_pos = left_.find_position(left_key);
 
-    node_t* new_node = new node_t(left_key, right_t());
+    node_t* new_node = create_node(left_key, right_t());
 
     left_.insert(left_pos, *new_node);
 
     left_.erase(left_it);
     right_.insert(right_pos, *new_node);
-    delete right_it.get_node();
+    destroy_node(right_it.get_node());
     return new_node->get_right();
   }
 
@@ -237,13 +407,13 @@ public:
     auto right_it = left_it.flip();
     auto right_pos = right_.find_position(right_key);
 
-    node_t* new_node = new node_t(left_t(), right_key);
+    node_t* new_node = create_node(left_t(), right_key);
 
     right_.insert(right_pos, *new_node);
 
     right_.erase(right_it);
     left_.insert(left_pos, *new_node);
-    delete left_it.get_node();
+    destroy_node(left_it.get_node());
     return new_node->get_left();
   }
 
@@ -287,7 +457,90 @@ public:
     return size_;
   }
 
+  // Checks the links, balance and order of both trees in O(n). Meant for tests.
+  bool check_invariants() const {
+    return left_.check_invariants() && right_.check_invariants();
+  }
+
 private:
+  template <bool PropagateAllocator>
+  void swap_contents(bimap& other) noexcept {
+    using std::swap;
+    swap(sent_, other.sent_);
+    swap(left_, other.left_);
+    swap(right_, other.right_);
+    swap(size_, other.size_);
+    pool_.template swap_storage<PropagateAllocator>(other.pool_);
+  }
+
+  // Copies the pairs of `other` and links them into both trees in the order they already have there. The copy of
+  // every node of the right tree is found through a hash table keyed by the address of the original, so besides
+  // copying the values the work is expected O(n). Moves the values out of `other` instead if it is an rvalue.
+  template <typename Other>
+  void clone(Other&& other) {
+    if (other.empty()) {
+      return;
+    }
+    // Open addressing with linear probing, at most half full.
+    const std::size_t table_size = std::bit_ceil(2 * other.size());
+    const int shift = std::numeric_limits<std::uint64_t>::digits - std::countr_zero(table_size);
+    std::vector<std::pair<const node_t*, node_t*>> copies(table_size, {nullptr, nullptr});
+    auto find_slot = [&](const node_t* original) {
+      // Fibonacci hashing: the high bits of the product depend on all bits of the address.
+      auto hash = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(original)) * 0x9e3779b97f4a7c15;
+      std::size_t slot = static_cast<std::size_t>(hash >> shift);
+      while (copies[slot].first != nullptr && copies[slot].first != original) {
+        slot = (slot + 1) & (table_size - 1);
+      }
+      return slot;
+    };
+
+    std::vector<node_t*> left_nodes;
+    std::vector<node_t*> right_nodes;
+    left_nodes.reserve(other.size());
+    right_nodes.reserve(other.size());
+
+    try {
+      for (auto it = other.begin_left(); it != other.end_left(); ++it) {
+        if constexpr (std::is_lvalue_reference_v<Other>) {
+          left_nodes.push_back(create_node(*it, *it.flip()));
+        } else {
+          left_nodes.push_back(create_node(it.get_node()->take_left(), it.get_node()->take_right()));
+        }
+        copies[find_slot(it.get_node())] = {it.get_node(), left_nodes.back()};
+      }
+    } catch (...) {
+      for (node_t* node : left_nodes) {
+        destroy_node(node);
+      }
+      throw;
+    }
+
+    for (auto it = other.begin_right(); it != other.end_right(); ++it) {
+      right_nodes.push_back(copies[find_slot(it.get_node())].second);
+    }
+
+    left_.assign_sorted(left_nodes.begin(), left_nodes.end());
+    right_.assign_sorted(right_nodes.begin(), right_nodes.end());
+    size_ = other.size();
+  }
+
+  template <typename L, typename R>
+  node_t* create_node(L&& left, R&& right) {
+    void* storage = pool_.allocate();
+    try {
+      return ::new (storage) node_t(std::forward<L>(left), std::forward<R>(right));
+    } catch (...) {
+      pool_.deallocate(storage);
+      throw;
+    }
+  }
+
+  void destroy_node(node_t* node) noexcept {
+    node->~node_t();
+    pool_.deallocate(node);
+  }
+
   bool equal_left(const left_t& lhs, const left_t& rhs) const {
     return !left_.compare(lhs, rhs) && !left_.compare(rhs, lhs);
   }
@@ -320,4 +573,5 @@ private:
   intrusive::bst<left_t, node_t, CompareLeft, left_tag> left_;
   intrusive::bst<right_t, node_t, CompareRight, right_tag> right_;
   size_t size_ = 0;
+  pool_t pool_;
 };
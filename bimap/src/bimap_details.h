@@ -34,6 +34,15 @@ struct node_with_value : node_base {
     return right_data_;
   }
 
+  // For moving the values out of a node that is about to be destroyed.
+  Left&& take_left() {
+    return std::move(left_data_);
+  }
+
+  Right&& take_right() {
+    return std::move(right_data_);
+  }
+
   template <typename Tag>
   const auto& get_value() const {
     if constexpr (std::is_same_v<Tag, left_tag>) {
@@ -3,6 +3,7 @@
 #include "bst_iterator.h"
 
 #include <algorithm>
+#include <bit>
 #include <iterator>
 #include <utility>
 
@@ -83,15 +84,46 @@ public:
       return {to_node_pointer(&k)};
     }
     node* ptr = to_node_pointer(&k);
-    if (pos.type == position::LEFT_SON) {
+    bool is_left = pos.type == position::LEFT_SON;
+    if (is_left) {
       pos.node_ptr->set_left(ptr);
     } else {
       pos.node_ptr->set_right(ptr);
     }
-    balance_up(ptr);
+    retrace_insert(pos.node_ptr, is_left);
     return {ptr};
   }
 
+  // Links the nodes of [first, last), sorted and unique under this tree's order, into an empty tree.
+  // The result is perfectly balanced and takes O(n) without any comparisons or rotations.
+  template <std::random_access_iterator It>
+  void assign_sorted(It first, It last) noexcept {
+    parent()->set_left(build_sorted(first, last));
+  }
+
+  // Empties the tree and passes every node to `dispose`, children before their parents, without rebalancing.
+  template <typename Dispose>
+  void clear(Dispose dispose) noexcept {
+    node* p = root();
+    detach_all();
+    while (p != nullptr) {
+      if (p->left_ != nullptr) {
+        p = std::exchange(p->left_, nullptr);
+      } else if (p->right_ != nullptr) {
+        p = std::exchange(p->right_, nullptr);
+      } else {
+        node* up = p->parent();
+        dispose(*static_cast<Node*>(static_cast<bst_element<Tag>*>(p)));
+        p = up == parent() ? nullptr : up;
+      }
+    }
+  }
+
+  // Empties the tree without touching its nodes, which have to be disposed of by other means.
+  void detach_all() noexcept {
+    parent()->left_ = nullptr;
+  }
+
   bool empty() const noexcept {
     return root() != nullptr;
   }
@@ -128,14 +160,27 @@ public:
 
     node* p = pos.current;
     if (p->right_ == nullptr) {
+      node* up = p->parent();
+      bool is_left = up->left_ == p;
       p->link_with_parent(p->left_);
-    } else {
-      node* min = goto_min(p->right_);
-      min->set_right(remove_min(p->right_));
-      min->set_left(p->left_);
-      p->link_with_parent(min);
-      balance_up(min);
+      retrace_erase(up, is_left);
+      return next;
     }
+
+    // The successor takes the place and balance of `p`, heights change only on the path it was taken from.
+    node* min = goto_min(p->right_);
+    node* changed = min;
+    bool is_left = false;
+    if (min != p->right_) {
+      changed = min->parent();
+      is_left = true;
+      changed->set_left(min->right_);
+      min->set_right(p->right_);
+    }
+    min->set_left(p->left_);
+    min->set_balance(p->balance());
+    p->link_with_parent(min);
+    retrace_erase(changed, is_left);
     return next;
   }
 
@@ -153,6 +198,20 @@ public:
     return comparator_;
   }
 
+  // Checks the parent links, balance factors and order of the whole tree in O(n). Meant for tests.
+  bool check_invariants() const {
+    if (checked_height(root(), parent()) < 0) {
+      return false;
+    }
+    for (iterator it = begin(); it != end(); ++it) {
+      iterator next = std::next(it);
+      if (next != end() && !compare(it->template get_value<Tag>(), next->template get_value<Tag>())) {
+        return false;
+      }
+    }
+    return true;
+  }
+
 private:
   static node_pointer to_node_pointer(Node* p) {
     return static_cast<node*>(static_cast<bst_element<Tag>*>(p));
@@ -170,19 +229,37 @@ private:
     if (!p) {
       return {parent(), position::LEFT_SON};
     }
-    if (comparator_(k, to_value(p))) {
-      if (p->left_) {
-        return find_position(p->left_, k);
+    while (true) {
+      if (comparator_(k, to_value(p))) {
+        if (!p->left_) {
+          return {p, position::LEFT_SON};
+        }
+        p = p->left_;
+      } else if (comparator_(to_value(p), k)) {
+        if (!p->right_) {
+          return {p, position::RIGHT_SON};
+        }
+        p = p->right_;
+      } else {
+        return {p, position::CURRENT};
       }
-      return position{p, position::LEFT_SON};
     }
-    if (comparator_(to_value(p), k)) {
-      if (p->right_) {
-        return find_position(p->right_, k);
-      }
-      return {p, position::RIGHT_SON};
+  }
+
+  template <typename It>
+  node* build_sorted(It first, It last) noexcept {
+    if (first == last) {
+      return nullptr;
     }
-    return {p, position::CURRENT};
+    It middle = first + (last - first) / 2;
+    node* p = to_node_pointer(*middle);
+    p->set_left(build_sorted(first, middle));
+    p->set_right(build_sorted(middle + 1, last));
+    // A subtree of n nodes built this way is std::bit_width(n) high.
+    auto left_size = static_cast<std::size_t>(middle - first);
+    auto right_size = static_cast<std::size_t>(last - middle - 1);
+    p->set_balance(static_cast<int>(std::bit_width(right_size)) - static_cast<int>(std::bit_width(left_size)));
+    return p;
   }
 
   node* lower_bound(node* t, const value_type& x) const {
@@ -198,75 +275,127 @@ private:
     return res ? res : parent();
   }
 
-  node* remove_min(node* p) noexcept {
-    if (p->left_ == nullptr) {
-      return p->right_;
+  // Updates balance factors on the way up from `p`, whose left or right subtree grew by one. Stops at the
+  // first subtree that keeps its height, which after an insertion is at the latest the first rotated one.
+  void retrace_insert(node* p, bool from_left) noexcept {
+    while (p != parent()) {
+      int b = p->balance() + (from_left ? -1 : 1);
+      if (b == 0) {
+        p->set_balance(0);
+        return;
+      }
+      node* up = p->parent();
+      bool is_left = up->left_ == p;
+      if (b == 2 || b == -2) {
+        replace_child(up, is_left, rebalance(p, b));
+        return;
+      }
+      p->set_balance(b);
+      from_left = is_left;
+      p = up;
     }
-    p->set_left(remove_min(p->left_));
-    return balance(p);
   }
 
-  void balance_up(node* p) noexcept {
-    if (p == nullptr || p == parent()) {
-      return;
-    }
-    node* up = p->parent_;
-    if (up->left_ == p) {
-      up->set_left(balance(p));
-    } else {
-      up->set_right(balance(p));
+  // Same as `retrace_insert` for a subtree that shrank by one. Rotations here may lower the height of the
+  // rotated subtree, so the walk can go on up to the root.
+  void retrace_erase(node* p, bool from_left) noexcept {
+    while (p != parent()) {
+      int b = p->balance() + (from_left ? 1 : -1);
+      if (b == 1 || b == -1) {
+        p->set_balance(b);
+        return;
+      }
+      node* up = p->parent();
+      bool is_left = up->left_ == p;
+      if (b == 0) {
+        p->set_balance(0);
+      } else {
+        node* q = rebalance(p, b);
+        replace_child(up, is_left, q);
+        if (q->balance() != 0) {
+          return;
+        }
+      }
+      from_left = is_left;
+      p = up;
     }
-    balance_up(up);
-  }
-
-  int32_t get_size(node* p) const noexcept {
-    return p ? p->depth_ : 0;
   }
 
-  void recalc(node* t) noexcept {
-    if (t == nullptr) {
-      return;
+  static void replace_child(node* up, bool is_left, node* child) noexcept {
+    if (is_left) {
+      up->set_left(child);
+    } else {
+      up->set_right(child);
     }
-    t->depth_ = 1 + std::max(get_size(t->left_), get_size(t->right_));
   }
 
-  node* rotate_right(node* p) noexcept {
+  static node* rotate_right(node* p) noexcept {
     node* q = p->left_;
     p->set_left(q->right_);
     q->set_right(p);
-    recalc(p);
-    recalc(q);
     return q;
   }
 
-  node* rotate_left(node* p) noexcept {
+  static node* rotate_left(node* p) noexcept {
     node* r = p->right_;
     p->set_right(r->left_);
     r->set_left(p);
-    recalc(p);
-    recalc(r);
     return r;
   }
 
-  int32_t bfactor(node* p) const noexcept {
-    return p ? get_size(p->right_) - get_size(p->left_) : 0;
+  // Restores the balance of `p`, which would be `b` (2 or -2) after a change in its subtrees, and returns the
+  // new root of the subtree. The caller links it in place of `p`.
+  static node* rebalance(node* p, int b) noexcept {
+    if (b == 2) {
+      node* r = p->right_;
+      int rb = r->balance();
+      if (rb >= 0) {
+        rotate_left(p);
+        p->set_balance(rb == 0 ? 1 : 0);
+        r->set_balance(rb == 0 ? -1 : 0);
+        return r;
+      }
+      node* q = r->left_;
+      int qb = q->balance();
+      p->set_right(rotate_right(r));
+      rotate_left(p);
+      p->set_balance(qb == 1 ? -1 : 0);
+      r->set_balance(qb == -1 ? 1 : 0);
+      q->set_balance(0);
+      return q;
+    }
+    node* l = p->left_;
+    int lb = l->balance();
+    if (lb <= 0) {
+      rotate_right(p);
+      p->set_balance(lb == 0 ? -1 : 0);
+      l->set_balance(lb == 0 ? 1 : 0);
+      return l;
+    }
+    node* q = l->right_;
+    int qb = q->balance();
+    p->set_left(rotate_left(l));
+    rotate_right(p);
+    p->set_balance(qb == -1 ? 1 : 0);
+    l->set_balance(qb == 1 ? -1 : 0);
+    q->set_balance(0);
+    return q;
   }
 
-  node* balance(node* p) noexcept {
-    recalc(p);
-    if (bfactor(p) == 2) {
-      if (bfactor(p->right_) < 0) {
-        p->set_right(rotate_right(p->right_));
-      }
-      return rotate_left(p);
+  // Height of the subtree of `p`, or -1 if a parent link or balance factor in it is wrong.
+  static int checked_height(const node* p, const node* up) noexcept {
+    if (p == nullptr) {
+      return 0;
     }
-    if (bfactor(p) == -2) {
-      if (bfactor(p->left_) > 0) {
-        p->set_left(rotate_left(p->left_));
-      }
-      return rotate_right(p);
+    if (p->parent() != up) {
+      return -1;
     }
-    return p;
+    int left = checked_height(p->left_, p);
+    int right = checked_height(p->right_, p);
+    if (left < 0 || right < 0 || right - left != p->balance()) {
+      return -1;
+    }
+    return std::max(left, right) + 1;
   }
 
   node* root() const noexcept {
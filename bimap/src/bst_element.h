@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <utility>
 
 namespace intrusive {
@@ -23,14 +24,13 @@ protected:
 
 public:
   bool is_linked() const noexcept {
-    return parent_ != this;
+    return parent() != this;
   }
 
   void unlink() noexcept {
-    parent_ = this;
+    parent_ = pack(this, 0);
     left_ = nullptr;
     right_ = nullptr;
-    depth_ = 1;
   }
 
   bst_element_base(bst_element_base&& other) noexcept
@@ -40,26 +40,26 @@ public:
 
   bst_element_base& operator=(bst_element_base&& other) noexcept {
     if (this != &other) {
-      parent_ = std::exchange(other.parent_, &other);
-      if (parent_ == &other) {
-        parent_ = this;
+      parent_ = std::exchange(other.parent_, pack(&other, 0));
+      if (parent() == &other) {
+        set_parent(this);
       }
 
-      if (parent_ != this) {
-        if (&other == parent_->left_) {
-          parent_->left_ = this;
+      if (parent() != this) {
+        if (&other == parent()->left_) {
+          parent()->left_ = this;
         } else {
-          parent_->right_ = this;
+          parent()->right_ = this;
         }
       }
 
       left_ = std::exchange(other.left_, nullptr);
       right_ = std::exchange(other.right_, nullptr);
       if (left_) {
-        left_->parent_ = this;
+        left_->set_parent(this);
       }
       if (right_) {
-        right_->parent_ = this;
+        right_->set_parent(this);
       }
     }
     return *this;
@@ -68,25 +68,25 @@ public:
   void set_left(bst_element_base* new_left) {
     left_ = new_left;
     if (new_left != nullptr) {
-      new_left->parent_ = this;
+      new_left->set_parent(this);
     }
   }
 
   void set_right(bst_element_base* new_right) {
     right_ = new_right;
     if (new_right != nullptr) {
-      new_right->parent_ = this;
+      new_right->set_parent(this);
     }
   }
 
   void link_with_parent(bst_element_base* v) {
-    if (parent_->left_ == this) {
-      parent_->left_ = v;
+    if (parent()->left_ == this) {
+      parent()->left_ = v;
     } else {
-      parent_->right_ = v;
+      parent()->right_ = v;
     }
     if (v) {
-      v->parent_ = parent_;
+      v->set_parent(parent());
     }
   }
 
@@ -97,7 +97,6 @@ public:
     parent_ = other.parent_;
     left_ = other.left_;
     right_ = other.right_;
-    depth_ = other.depth_;
     return *this;
   }
 
@@ -124,11 +123,38 @@ public:
   }
 
 protected:
-  bst_element_base* parent_ = this;
+  bst_element_base* parent() const noexcept {
+    return reinterpret_cast<bst_element_base*>(parent_ & ~balance_mask);
+  }
+
+  void set_parent(bst_element_base* p) noexcept {
+    parent_ = pack(p, balance());
+  }
+
+  // Height of the right subtree minus height of the left one, always -1, 0 or 1 between operations.
+  int balance() const noexcept {
+    return static_cast<int>(parent_ & balance_mask) - 1;
+  }
+
+  void set_balance(int balance) noexcept {
+    parent_ = pack(parent(), balance);
+  }
+
+private:
+  // Elements are pointer-aligned, so the low bits of the parent pointer are free to hold the balance factor.
+  static constexpr std::uintptr_t balance_mask = 3;
+
+  static std::uintptr_t pack(const bst_element_base* p, int balance) noexcept {
+    return reinterpret_cast<std::uintptr_t>(p) | static_cast<std::uintptr_t>(balance + 1);
+  }
+
+protected:
+  std::uintptr_t parent_ = pack(this, 0);
   bst_element_base* left_ = nullptr;
   bst_element_base* right_ = nullptr;
-  std::size_t depth_ = 1;
 };
+
+static_assert(alignof(bst_element_base) > 2, "the balance factor is stored in the low bits of a pointer");
 } // namespace details
 
 template <typename Tag = default_tag>
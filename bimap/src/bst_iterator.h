@@ -38,10 +38,10 @@ public:
       return *this;
     }
 
-    while (current == current->parent_->right_) {
-      current = current->parent_;
+    while (current == current->parent()->right_) {
+      current = current->parent();
     }
-    current = current->parent_;
+    current = current->parent();
     return *this;
   }
 
@@ -57,10 +57,10 @@ public:
       return *this;
     }
 
-    while (current->parent_ != current && current == current->parent_->left_) {
-      current = current->parent_;
+    while (current->parent() != current && current == current->parent()->left_) {
+      current = current->parent();
     }
-    current = current->parent_;
+    current = current->parent();
     return *this;
   }
 
@@ -71,7 +71,7 @@ public:
   }
 
   bool is_end() const noexcept {
-    return current == current->parent_;
+    return current == current->parent();
   }
 
   friend bool operator==(const bst_iterator& lhs, const bst_iterator& rhs) {
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace details {
+
+// Hands out storage for nodes from slabs obtained through `Allocator`. Freed nodes go to a free list and are
+// reused before a slab is touched again, slabs are only returned by `release` and the destructor.
+template <typename T, typename Allocator>
+class node_pool {
+  static constexpr std::size_t cache_line = 64;
+  // Nodes that fit in a cache line are aligned so that none of them straddles two.
+  static constexpr std::size_t slot_alignment =
+      std::max(alignof(T), sizeof(T) <= cache_line ? std::bit_ceil(sizeof(T)) : std::size_t(1));
+
+  union alignas(slot_alignment) slot {
+    slot* next;
+    alignas(T) std::byte storage[sizeof(T)];
+  };
+
+  struct slab_header {
+    slot* next_slab;
+    std::size_t size;
+  };
+
+  static_assert(sizeof(slab_header) <= sizeof(slot));
+
+  using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<slot>;
+  using slot_traits = std::allocator_traits<slot_allocator>;
+
+  static constexpr std::size_t min_slab_size = 16;
+  static constexpr std::size_t max_slab_size = 4096;
+
+public:
+  explicit node_pool(const Allocator& alloc = Allocator())
+      : alloc_(alloc) {}
+
+  node_pool(const node_pool&) = delete;
+  node_pool& operator=(const node_pool&) = delete;
+
+  node_pool(node_pool&& other) noexcept
+      : alloc_(std::move(other.alloc_))
+      , slabs_(std::exchange(other.slabs_, nullptr))
+      , free_(std::exchange(other.free_, nullptr))
+      , unused_(std::exchange(other.unused_, nullptr))
+      , unused_end_(std::exchange(other.unused_end_, nullptr)) {}
+
+  ~node_pool() noexcept {
+    release();
+  }
+
+  // Exchanges the slabs of two pools. The allocators are exchanged too if `PropagateAllocator` is set,
+  // otherwise they must compare equal.
+  template <bool PropagateAllocator>
+  void swap_storage(node_pool& other) noexcept {
+    using std::swap;
+    if constexpr (PropagateAllocator) {
+      swap(alloc_, other.alloc_);
+    }
+    swap(slabs_, other.slabs_);
+    swap(free_, other.free_);
+    swap(unused_, other.unused_);
+    swap(unused_end_, other.unused_end_);
+  }
+
+  // Follows `propagate_on_container_swap`: unless it is set, the allocators must compare equal.
+  friend void swap(node_pool& lhs, node_pool& rhs) noexcept {
+    lhs.swap_storage<std::allocator_traits<Allocator>::propagate_on_container_swap::value>(rhs);
+  }
+
+  Allocator get_allocator() const noexcept {
+    return Allocator(alloc_);
+  }
+
+  // Whether storage from `other` can be deallocated by this pool.
+  bool same_allocator(const node_pool& other) const noexcept {
+    return slot_traits::is_always_equal::value || alloc_ == other.alloc_;
+  }
+
+  void* allocate() {
+    if (free_ != nullptr) {
+      return std::exchange(free_, free_->next);
+    }
+    if (unused_ == unused_end_) {
+      add_slab();
+    }
+    return unused_++;
+  }
+
+  void deallocate(void* p) noexcept {
+    slot* s = static_cast<slot*>(p);
+    s->next = free_;
+    free_ = s;
+  }
+
+  // Returns every slab to the allocator. No storage handed out by the pool may be in use.
+  void release() noexcept {
+    while (slabs_ != nullptr) {
+      slab_header* header = header_of(slabs_);
+      slot* next = header->next_slab;
+      std::size_t size = header->size;
+      slot_traits::deallocate(alloc_, slabs_, size);
+      slabs_ = next;
+    }
+    free_ = nullptr;
+    unused_ = nullptr;
+    unused_end_ = nullptr;
+  }
+
+private:
+  static slab_header* header_of(slot* slab) noexcept {
+    return std::launder(reinterpret_cast<slab_header*>(slab));
+  }
+
+  // The first slot of every slab holds its header, the rest are carved out in order.
+  void add_slab() {
+    std::size_t size = min_slab_size;
+    if (slabs_ != nullptr) {
+      size = std::min(header_of(slabs_)->size * 2, max_slab_size);
+    }
+    slot* slab = slot_traits::allocate(alloc_, size);
+    ::new (static_cast<void*>(slab)) slab_header{slabs_, size};
+    slabs_ = slab;
+    unused_ = slab + 1;
+    unused_end_ = slab + size;
+  }
+
+private:
+  [[no_unique_address]] slot_allocator alloc_;
+  slot* slabs_ = nullptr;
+  slot* free_ = nullptr;
+  slot* unused_ = nullptr;
+  slot* unused_end_ = nullptr;
+};
+
+} // namespace details
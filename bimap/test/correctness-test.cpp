@@ -4,6 +4,9 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <numeric>
 #include <random>
 
 template class bimap<int, non_default_constructible>;
@@ -256,6 +259,49 @@ TEST_CASE("At-or-default") {
   CHECK(b.at_right(-1000) == 0);
 }
 
+TEST_CASE("Trees stay balanced") {
+  static constexpr int N = 1'000;
+
+  // Shuffled, so that the default keys land on inner nodes and replacing their pair moves nonzero balances.
+  std::vector<int> keys(N);
+  std::iota(keys.begin(), keys.end(), -N / 2);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(std::mt19937::default_seed));
+  bimap<int, int> b;
+  for (int key : keys) {
+    b.insert(key, -key);
+  }
+  REQUIRE(b.check_invariants());
+
+  SECTION("erasing nodes without a right child") {
+    // The largest key never has a right child.
+    for (int i = N / 2 - 1; i >= 0; --i) {
+      b.erase_left(i);
+      REQUIRE(b.check_invariants());
+    }
+    for (int i = N / 2; i > 0; --i) {
+      b.erase_right(i);
+      REQUIRE(b.check_invariants());
+    }
+    CHECK(b.empty());
+  }
+
+  SECTION("at_left_or_default replacing a pair") {
+    for (int i = N; i < 2 * N; ++i) {
+      CHECK(b.at_left_or_default(i) == 0);
+      REQUIRE(b.check_invariants());
+    }
+    CHECK(b.size() == N);
+  }
+
+  SECTION("at_right_or_default replacing a pair") {
+    for (int i = N; i < 2 * N; ++i) {
+      CHECK(b.at_right_or_default(i) == 0);
+      REQUIRE(b.check_invariants());
+    }
+    CHECK(b.size() == N);
+  }
+}
+
 TEST_CASE("At-or-default does not invoke copy assignment") {
   bimap<non_copy_assignable, non_copy_assignable> b;
   b.insert(non_copy_assignable(4), non_copy_assignable(2));
@@ -481,6 +527,35 @@ TEST_CASE("Copy constructor") {
   CHECK(a == b);
 }
 
+TEST_CASE("Copy constructor does not compare keys") {
+  using bm = bimap<int, int, tracking_comparator, tracking_comparator>;
+  bool left_called = false;
+  bool right_called = false;
+  bm a(tracking_comparator{&left_called}, tracking_comparator{&right_called});
+
+  std::mt19937 rng(std::mt19937::default_seed);
+  for (int i = 0; i < 1'000; ++i) {
+    a.insert(static_cast<int>(rng() % 10'000), static_cast<int>(rng() % 10'000));
+  }
+
+  left_called = right_called = false;
+  bm b = a;
+  CHECK_FALSE(left_called);
+  CHECK_FALSE(right_called);
+  CHECK(a == b);
+
+  for (auto it = a.begin_right(); it != a.end_right(); ++it) {
+    CHECK(b.at_right(*it) == *it.flip());
+  }
+  for (int i = 0; i < 1'000; ++i) {
+    b.erase_left(static_cast<int>(rng() % 10'000));
+    b.insert(static_cast<int>(rng() % 10'000), static_cast<int>(rng() % 10'000));
+  }
+  CHECK(std::is_sorted(b.begin_left(), b.end_left()));
+  CHECK(std::is_sorted(b.begin_right(), b.end_right()));
+  CHECK(static_cast<size_t>(std::distance(b.begin_right(), b.end_right())) == b.size());
+}
+
 TEST_CASE("Copy assignment") {
   bimap<int, int> a;
   a.insert(1, 4);
@@ -715,6 +790,21 @@ TEST_CASE("Iterator sizeof") {
   STATIC_CHECK(sizeof(bm::right_iterator) <= sizeof(void*));
 }
 
+TEST_CASE("Node fits in a cache line") {
+  STATIC_CHECK(sizeof(details::node_with_value<int, int>) <= 64);
+
+  bimap<int, int> b;
+  for (int i = 0; i < 1'000; ++i) {
+    b.insert(i, -i);
+  }
+  for (int i = 0; i < 1'000; ++i) {
+    auto it = b.find_left(i);
+    auto left = reinterpret_cast<std::uintptr_t>(&*it);
+    auto right = reinterpret_cast<std::uintptr_t>(&*it.flip());
+    CHECK(left / 64 == right / 64);
+  }
+}
+
 TEST_CASE("Iterator operations") {
   bimap<int, int> b;
   b.insert(3, 4);
@@ -802,3 +892,187 @@ TEST_CASE("Swap with tracking comparator") {
   CHECK(cmp1_left == false);
   CHECK(cmp1_right == false);
 }
+
+TEST_CASE("Custom allocator") {
+  using bm = bimap<int, int, std::less<>, std::less<>, counting_allocator<std::pair<int, int>>>;
+  static constexpr int N = 1'000;
+
+  allocation_stats stats;
+  {
+    bm b(counting_allocator<std::pair<int, int>>{&stats});
+    CHECK(b.get_allocator().stats == &stats);
+    for (int i = 0; i < N; ++i) {
+      b.insert(i, N - i);
+    }
+    CHECK(b.size() == N);
+    CHECK(stats.allocations > 0);
+    CHECK(stats.allocations < N / 10);
+    size_t allocations = stats.allocations;
+
+    b.erase_left(b.begin_left(), b.end_left());
+    for (int i = 0; i < N; ++i) {
+      b.insert(N - i, i);
+    }
+    CHECK(stats.allocations == allocations);
+    CHECK(b.at_left(1) == N - 1);
+
+    bm moved = std::move(b);
+    CHECK(moved.get_allocator().stats == &stats);
+    CHECK(moved.size() == N);
+  }
+  CHECK(stats.outstanding == 0);
+}
+
+TEST_CASE("Polymorphic allocator") {
+  using bm = bimap<int, int, std::less<>, std::less<>, std::pmr::polymorphic_allocator<std::pair<int, int>>>;
+  static constexpr int N = 100;
+
+  std::pmr::unsynchronized_pool_resource first_resource;
+  std::pmr::unsynchronized_pool_resource second_resource;
+  bm a(&first_resource);
+  bm b(&second_resource);
+  for (int i = 0; i < N; ++i) {
+    a.insert(i, -i);
+    b.insert(-i, i);
+  }
+  bm b_copy = b;
+  CHECK(b_copy.get_allocator().resource() == std::pmr::get_default_resource());
+
+  SECTION("copy assignment keeps the allocator") {
+    a = b;
+    CHECK(a.get_allocator().resource() == &first_resource);
+    CHECK(a == b);
+  }
+
+  SECTION("move assignment from another resource moves the pairs") {
+    a = std::move(b);
+    CHECK(a.get_allocator().resource() == &first_resource);
+    CHECK(a == b_copy);
+    CHECK(b.empty());
+    b.insert(1, 2);
+    CHECK(b.at_left(1) == 2);
+  }
+
+  SECTION("move assignment from the same resource") {
+    bm c(&first_resource);
+    c.insert(1, 2);
+    const int* address = &*c.find_left(1);
+    a = std::move(c);
+    CHECK(a.size() == 1);
+    CHECK(&*a.find_left(1) == address);
+  }
+
+  SECTION("swap") {
+    bm c(&first_resource);
+    c.insert(1, 2);
+    swap(a, c);
+    CHECK(a.size() == 1);
+    CHECK(c.size() == N);
+    CHECK(a.get_allocator().resource() == &first_resource);
+    CHECK(c.at_left(N - 1) == 1 - N);
+  }
+}
+
+TEST_CASE("Erased nodes are reused") {
+  bimap<int, int> b;
+  b.insert(1, 2);
+  b.insert(3, 4);
+  const int* address = &*b.find_left(3);
+  b.erase_left(3);
+  b.insert(5, 6);
+  CHECK(&*b.find_left(5) == address);
+
+  b.clear();
+  CHECK(b.empty());
+  b.insert(7, 8);
+  CHECK(b.at_left(7) == 8);
+}
+
+TEST_CASE("Range constructor") {
+  std::vector<std::pair<int, int>> pairs;
+  for (int i = 0; i < 1'000; ++i) {
+    pairs.emplace_back(i, (i * 7919) % 1'000);
+  }
+
+  bimap<int, int> expected;
+  for (auto [left, right] : pairs) {
+    expected.insert(left, right);
+  }
+
+  SECTION("sorted") {
+    bimap<int, int> b(pairs.begin(), pairs.end());
+    CHECK(b.size() == pairs.size());
+    CHECK(b == expected);
+  }
+
+  SECTION("unsorted") {
+    std::shuffle(pairs.begin(), pairs.end(), std::mt19937(std::mt19937::default_seed));
+    bimap<int, int> b(pairs.begin(), pairs.end());
+    CHECK(b == expected);
+    CHECK(b.at_right(7919 % 1'000) == 1);
+  }
+
+  SECTION("with comparators") {
+    bimap<int, int, std::greater<>> b(pairs.begin(), pairs.end(), std::greater<>());
+    CHECK(*b.begin_left() == 999);
+    CHECK(b.size() == pairs.size());
+  }
+
+  SECTION("builds balanced trees") {
+    for (std::size_t size : {0, 1, 2, 3, 7, 8, 100, 1'000}) {
+      bimap<int, int> b(pairs.begin(), pairs.begin() + size);
+      CHECK(b.size() == size);
+      CHECK(b.check_invariants());
+    }
+  }
+
+  SECTION("stays balanced") {
+    bimap<int, int> b(pairs.begin(), pairs.end());
+    for (int i = 0; i < 1'000; i += 2) {
+      b.erase_left(i);
+      REQUIRE(b.check_invariants());
+    }
+    b.insert(-1, -1);
+    CHECK(b.size() == 501);
+    CHECK(b.check_invariants());
+  }
+}
+
+TEST_CASE("Range constructor with repeated keys") {
+  std::vector<std::pair<int, int>> pairs = {{1, 10}, {2, 10}, {2, 20}, {1, 30}, {3, 30}, {4, 40}, {3, 50}};
+
+  bimap<int, int> expected;
+  for (auto [left, right] : pairs) {
+    expected.insert(left, right);
+  }
+
+  bimap<int, int> b(pairs.begin(), pairs.end());
+  CHECK(b == expected);
+  CHECK(b.size() == 4);
+  CHECK(b.at_left(2) == 20);
+}
+
+TEST_CASE("Range insert") {
+  std::vector<std::pair<int, int>> pairs = {{5, 1}, {3, 2}, {8, 3}, {1, 4}};
+
+  bimap<int, int> b;
+  b.insert(pairs.begin(), pairs.end());
+  CHECK(b.size() == 4);
+  CHECK(b.at_right(3) == 8);
+
+  std::vector<std::pair<int, int>> more = {{5, 6}, {6, 4}, {7, 7}};
+  b.insert(more.begin(), more.end());
+  CHECK(b.size() == 5);
+  CHECK(b.at_left(7) == 7);
+  CHECK(b.at_left(5) == 1);
+
+  std::vector<std::pair<test_object, test_object>> objects;
+  objects.emplace_back(test_object(2), test_object(3));
+  objects.emplace_back(test_object(1), test_object(4));
+  bimap<test_object, test_object> moved(
+      std::make_move_iterator(objects.begin()),
+      std::make_move_iterator(objects.end())
+  );
+  CHECK(moved.size() == 2);
+  CHECK(moved.at_left(test_object(1)) == test_object(4));
+}
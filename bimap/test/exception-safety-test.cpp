@@ -6,6 +6,8 @@
 
 #include <algorithm>
 #include <random>
+#include <utility>
+#include <vector>
 
 namespace {
 
@@ -128,6 +130,20 @@ TEST_CASE("Copy constructor is exception-safe") {
   });
 }
 
+TEST_CASE("Range constructor is exception-safe") {
+  faulty_run([] {
+    std::vector<std::pair<element, element>> pairs;
+    {
+      fault_injection_disable dg;
+      for (auto [left, right] : {std::pair{5, 6}, {1, 2}, {9, 10}, {3, 4}, {7, 8}, {3, 1}}) {
+        pairs.emplace_back(left, right);
+      }
+    }
+
+    bimap<element, element> b(pairs.begin(), pairs.end());
+  });
+}
+
 TEST_CASE("Copy assignment to empty is exception-safe") {
   faulty_run([] {
     bimap<element, element> a;
@@ -2,6 +2,7 @@
 
 #include <cmath>
 #include <functional>
+#include <memory>
 #include <stdexcept>
 #include <unordered_set>
 #include <utility>
@@ -258,3 +259,39 @@ public:
 private:
   bool* called;
 };
+
+struct allocation_stats {
+  size_t allocations = 0;
+  size_t outstanding = 0;
+};
+
+template <typename T>
+class counting_allocator {
+public:
+  using value_type = T;
+
+  explicit counting_allocator(allocation_stats* stats)
+      : stats(stats) {}
+
+  template <typename U>
+  counting_allocator(const counting_allocator<U>& other)
+      : stats(other.stats) {}
+
+  T* allocate(size_t n) {
+    ++stats->allocations;
+    stats->outstanding += n * sizeof(T);
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* p, size_t n) {
+    stats->outstanding -= n * sizeof(T);
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  template <typename U>
+  friend bool operator==(const counting_allocator& lhs, const counting_allocator<U>& rhs) {
+    return lhs.stats == rhs.stats;
+  }
+
+  allocation_stats* stats;
+};
@@ -0,0 +1,251 @@
+#include "bitset.h"
+
+#include <benchmark/benchmark.h>
+
+#include <charconv>
+#include <cstdint>
+#include <random>
+#include <string>
+
+namespace {
+
+constexpr std::size_t unaligned_offset = 13;
+// A different offset for the right operand, so that the two do not line up with each other either.
+constexpr std::size_t unaligned_rhs_offset = 29;
+// Sparse bitsets have one bit in this many set, dense ones half of them.
+constexpr std::size_t sparse_ratio = 1024;
+constexpr std::size_t pattern_bits = std::size_t(1) << 16;
+
+enum arg {
+  SIZE,
+  DENSE,
+  UNALIGNED,
+  RHS_UNALIGNED,
+};
+
+// Random bits repeating with a period of `pattern_bits`, so filling a gigabit takes a few doublings.
+bitset make_bitset(std::size_t size, bool dense, unsigned seed) {
+  std::mt19937_64 rng(seed);
+  bitset res(size, false);
+  const std::size_t pattern = std::min(size, pattern_bits);
+  for (std::size_t i = 0; i < pattern; ++i) {
+    res[i] = dense ? rng() % 2 == 0 : rng() % sparse_ratio == 0;
+  }
+  for (std::size_t filled = pattern; filled < size; filled *= 2) {
+    const std::size_t count = std::min(filled, size - filled);
+    res.subview(filled, count) |= res.subview(0, count);
+  }
+  return res;
+}
+
+// Operands of the benchmark. Unaligned ones are the last `size` bits of a bitset that is `unaligned_offset`
+// (`unaligned_rhs_offset` for the right operand) bits longer, so they start mid-word.
+struct operands {
+  explicit operands(const benchmark::State& state)
+      : size(static_cast<std::size_t>(state.range(SIZE)))
+      , offset(state.range(UNALIGNED) != 0 ? unaligned_offset : 0)
+      , rhs_offset(state.range(RHS_UNALIGNED) != 0 ? unaligned_rhs_offset : 0)
+      , lhs_bits(make_bitset(size + offset, state.range(DENSE) != 0, 1))
+      , rhs_bits(make_bitset(size + rhs_offset, state.range(DENSE) != 0, 2)) {}
+
+  bitset::view lhs() {
+    return lhs_bits.subview(offset, size);
+  }
+
+  bitset::const_view rhs() const {
+    return rhs_bits.subview(rhs_offset, size);
+  }
+
+  std::size_t size;
+  std::size_t offset;
+  std::size_t rhs_offset;
+  bitset lhs_bits;
+  bitset rhs_bits;
+};
+
+void set_bytes(benchmark::State& state, std::size_t bits, std::size_t operand_count) {
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * (bits / 8) * operand_count));
+}
+
+template <typename operation_type>
+void bench_assign(benchmark::State& state, operation_type operation) {
+  operands ops(state);
+  for (auto _ : state) {
+    operation(ops.lhs(), ops.rhs());
+    benchmark::ClobberMemory();
+  }
+  set_bytes(state, ops.size, 2);
+}
+
+void and_assign(benchmark::State& state) {
+  bench_assign(state, [](bitset::view lhs, bitset::const_view rhs) { lhs &= rhs; });
+}
+
+void or_assign(benchmark::State& state) {
+  bench_assign(state, [](bitset::view lhs, bitset::const_view rhs) { lhs |= rhs; });
+}
+
+void xor_assign(benchmark::State& state) {
+  bench_assign(state, [](bitset::view lhs, bitset::const_view rhs) { lhs ^= rhs; });
+}
+
+void flip(benchmark::State& state) {
+  bench_assign(state, [](bitset::view lhs, bitset::const_view) { lhs.flip(); });
+}
+
+void set_all(benchmark::State& state) {
+  bench_assign(state, [](bitset::view lhs, bitset::const_view) { lhs.set(); });
+}
+
+void reset_all(benchmark::State& state) {
+  bench_assign(state, [](bitset::view lhs, bitset::const_view) { lhs.reset(); });
+}
+
+void shift_left(benchmark::State& state) {
+  bench_assign(state, [](bitset::view lhs, bitset::const_view) { lhs.shift_left_inplace(unaligned_offset); });
+}
+
+void shift_right(benchmark::State& state) {
+  bench_assign(state, [](bitset::view lhs, bitset::const_view) { lhs.shift_right_inplace(unaligned_offset); });
+}
+
+// Evaluates `expression(lhs, rhs)` into a preallocated bitset, `operand_count` counts the result too.
+template <typename expression_type>
+void bench_expression(benchmark::State& state, std::size_t operand_count, expression_type expression) {
+  operands ops(state);
+  bitset res(ops.size, false);
+  for (auto _ : state) {
+    res = expression(ops.lhs(), ops.rhs());
+    benchmark::DoNotOptimize(res.begin());
+    benchmark::ClobberMemory();
+  }
+  set_bytes(state, ops.size, operand_count);
+}
+
+void and_expression(benchmark::State& state) {
+  bench_expression(state, 3, [](bitset::const_view lhs, bitset::const_view rhs) { return lhs & rhs; });
+}
+
+void or_expression(benchmark::State& state) {
+  bench_expression(state, 3, [](bitset::const_view lhs, bitset::const_view rhs) { return lhs | rhs; });
+}
+
+void xor_expression(benchmark::State& state) {
+  bench_expression(state, 3, [](bitset::const_view lhs, bitset::const_view rhs) { return lhs ^ rhs; });
+}
+
+void not_expression(benchmark::State& state) {
+  bench_expression(state, 2, [](bitset::const_view lhs, bitset::const_view) { return ~lhs; });
+}
+
+void binary_expression(benchmark::State& state) {
+  bench_expression(state, 3, [](bitset::const_view lhs, bitset::const_view rhs) { return lhs & ~rhs; });
+}
+
+void count(benchmark::State& state) {
+  operands ops(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ops.lhs().count());
+  }
+  set_bytes(state, ops.size, 1);
+}
+
+void all(benchmark::State& state) {
+  operands ops(state);
+  ops.lhs().set();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ops.lhs().all());
+  }
+  set_bytes(state, ops.size, 1);
+}
+
+void any(benchmark::State& state) {
+  operands ops(state);
+  ops.lhs().reset();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ops.lhs().any());
+  }
+  set_bytes(state, ops.size, 1);
+}
+
+void equal(benchmark::State& state) {
+  operands ops(state);
+  const bitset copy(ops.lhs());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ops.lhs() == copy);
+  }
+  set_bytes(state, ops.size, 2);
+}
+
+void for_each_set(benchmark::State& state) {
+  operands ops(state);
+  for (auto _ : state) {
+    std::size_t sum = 0;
+    ops.lhs().for_each_set([&](std::size_t i) { sum += i; });
+    benchmark::DoNotOptimize(sum);
+  }
+  set_bytes(state, ops.size, 1);
+}
+
+void to_chars(benchmark::State& state) {
+  operands ops(state);
+  std::string str(ops.size, '0');
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ops.lhs().to_chars(str.data(), str.data() + str.size()));
+    benchmark::ClobberMemory();
+  }
+  set_bytes(state, ops.size * 8, 1);
+}
+
+void from_chars(benchmark::State& state) {
+  operands ops(state);
+  const std::string str = ops.rhs().to_string();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ops.lhs().from_chars(str.data(), str.data() + str.size()));
+    benchmark::ClobberMemory();
+  }
+  set_bytes(state, ops.size * 8, 1);
+}
+
+// 64 bits to 1 Gbit, sparse and dense, aligned and unaligned.
+void word_operations(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"bits", "dense", "unaligned", "rhs_unaligned"});
+  bench->ArgsProduct({{64, 1 << 12, 1 << 20, 1 << 26, 1 << 30}, {0, 1}, {0, 1}, {0}});
+}
+
+// Same as `word_operations`, also with an unaligned right operand.
+void binary_operations(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"bits", "dense", "unaligned", "rhs_unaligned"});
+  bench->ArgsProduct({{64, 1 << 12, 1 << 20, 1 << 26, 1 << 30}, {0, 1}, {0, 1}, {0, 1}});
+}
+
+// Text is 8 times larger than the bits, so it stops at 64 Mbit.
+void text_operations(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"bits", "dense", "unaligned", "rhs_unaligned"});
+  bench->ArgsProduct({{64, 1 << 12, 1 << 20, 1 << 26}, {0, 1}, {0, 1}, {0}});
+}
+
+} // namespace
+
+BENCHMARK(and_assign)->Apply(binary_operations);
+BENCHMARK(or_assign)->Apply(binary_operations);
+BENCHMARK(xor_assign)->Apply(binary_operations);
+BENCHMARK(flip)->Apply(word_operations);
+BENCHMARK(set_all)->Apply(word_operations);
+BENCHMARK(reset_all)->Apply(word_operations);
+BENCHMARK(shift_left)->Apply(word_operations);
+BENCHMARK(shift_right)->Apply(word_operations);
+BENCHMARK(and_expression)->Apply(binary_operations);
+BENCHMARK(or_expression)->Apply(binary_operations);
+BENCHMARK(xor_expression)->Apply(binary_operations);
+BENCHMARK(not_expression)->Apply(word_operations);
+BENCHMARK(binary_expression)->Apply(binary_operations);
+BENCHMARK(count)->Apply(word_operations);
+BENCHMARK(all)->Apply(word_operations);
+BENCHMARK(any)->Apply(word_operations);
+BENCHMARK(equal)->Apply(word_operations);
+BENCHMARK(for_each_set)->Apply(word_operations);
+BENCHMARK(to_chars)->Apply(text_operations);
+BENCHMARK(from_chars)->Apply(text_operations);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,62 @@
+#include "bitset-parallel.h"
+#include "bitset.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+// 64 MiB per operand, far beyond any cache.
+constexpr std::size_t bench_bits = std::size_t(1) << 29;
+
+bts::parallel::options options_for(const benchmark::State& state) {
+  return {static_cast<std::size_t>(state.range(0)), 0};
+}
+
+void thread_counts(benchmark::internal::Benchmark* bench) {
+  const std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+  for (std::size_t threads = 1; threads < max_threads; threads *= 2) {
+    bench->Arg(static_cast<std::int64_t>(threads));
+  }
+  bench->Arg(static_cast<std::int64_t>(max_threads));
+}
+
+void parallel_and(benchmark::State& state) {
+  bitset lhs(bench_bits, true);
+  const bitset rhs(bench_bits, true);
+  const auto opts = options_for(state);
+  for (auto _ : state) {
+    bts::parallel::and_assign(lhs, rhs, opts);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bench_bits / 8 * 2));
+}
+
+void parallel_count(benchmark::State& state) {
+  const bitset bits(bench_bits, true);
+  const auto opts = options_for(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bts::parallel::count(bits, opts));
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bench_bits / 8));
+}
+
+void parallel_equal(benchmark::State& state) {
+  const bitset lhs(bench_bits, true);
+  const bitset rhs(bench_bits, true);
+  const auto opts = options_for(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bts::parallel::equal(lhs, rhs, opts));
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bench_bits / 8 * 2));
+}
+
+} // namespace
+
+BENCHMARK(parallel_and)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(parallel_count)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(parallel_equal)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,64 @@
+#include "atomic-bitset.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <utility>
+
+atomic_bitset::atomic_bitset(std::size_t size)
+    : _size(size)
+    , _words(std::make_unique<word_type[]>((size + bts::word_size - 1) / bts::word_size)) {}
+
+atomic_bitset::atomic_bitset(const bitset::const_view& bits)
+    : atomic_bitset(bits.size()) {
+  bitset::view(_words.get(), _size) |= bits;
+}
+
+atomic_bitset::atomic_bitset(atomic_bitset&& other) noexcept
+    : _size(std::exchange(other._size, 0))
+    , _words(std::move(other._words)) {}
+
+atomic_bitset& atomic_bitset::operator=(atomic_bitset&& other) noexcept {
+  if (&other != this) {
+    _size = std::exchange(other._size, 0);
+    _words = std::move(other._words);
+  }
+  return *this;
+}
+
+std::size_t atomic_bitset::size() const {
+  return _size;
+}
+
+std::size_t atomic_bitset::word_count() const {
+  return (_size + bts::word_size - 1) / bts::word_size;
+}
+
+std::size_t atomic_bitset::count(std::memory_order order) const {
+  std::size_t res = 0;
+  for (std::size_t i = 0; i < word_count(); ++i) {
+    res += std::popcount(load_word(i, order));
+  }
+  return res;
+}
+
+bitset atomic_bitset::snapshot(std::memory_order order) const {
+  // Words are loaded into a buffer first, so that the copy itself goes through the usual word-wise path.
+  constexpr std::size_t chunk_words = 256;
+  std::array<word_type, chunk_words> buffer;
+  bitset res(_size, false);
+  for (std::size_t first = 0; first < word_count(); first += chunk_words) {
+    const std::size_t count = std::min(word_count() - first, chunk_words);
+    for (std::size_t i = 0; i < count; ++i) {
+      buffer[i] = load_word(first + i, order);
+    }
+    const std::size_t pos = first * bts::word_size;
+    const std::size_t bits = std::min(_size - pos, count * bts::word_size);
+    res.subview(pos, bits) |= bitset::const_view(buffer.data(), bits);
+  }
+  return res;
+}
+
+bitset::const_view atomic_bitset::view() const {
+  return {_words.get(), _size};
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "bitset.h"
+#include "bts.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace bts::atomics {
+
+// Atomic read-modify-writes on plain words. Libraries without `std::atomic_ref` (libc++ gained it in
+// 19, and only then defines `__cpp_lib_atomic_ref`) get the builtins it would have used instead.
+#if defined(__cpp_lib_atomic_ref)
+
+inline word_type load(const word_type& word, std::memory_order order) {
+  return std::atomic_ref<word_type>(const_cast<word_type&>(word)).load(order);
+}
+
+inline word_type fetch_or(word_type& word, word_type value, std::memory_order order) {
+  return std::atomic_ref<word_type>(word).fetch_or(value, order);
+}
+
+inline word_type fetch_and(word_type& word, word_type value, std::memory_order order) {
+  return std::atomic_ref<word_type>(word).fetch_and(value, order);
+}
+
+inline word_type fetch_xor(word_type& word, word_type value, std::memory_order order) {
+  return std::atomic_ref<word_type>(word).fetch_xor(value, order);
+}
+
+#else
+
+constexpr int builtin_order(std::memory_order order) {
+  switch (order) {
+  case std::memory_order_relaxed:
+    return __ATOMIC_RELAXED;
+  case std::memory_order_consume:
+    return __ATOMIC_CONSUME;
+  case std::memory_order_acquire:
+    return __ATOMIC_ACQUIRE;
+  case std::memory_order_release:
+    return __ATOMIC_RELEASE;
+  case std::memory_order_acq_rel:
+    return __ATOMIC_ACQ_REL;
+  default:
+    return __ATOMIC_SEQ_CST;
+  }
+}
+
+inline word_type load(const word_type& word, std::memory_order order) {
+  return __atomic_load_n(&word, builtin_order(order));
+}
+
+inline word_type fetch_or(word_type& word, word_type value, std::memory_order order) {
+  return __atomic_fetch_or(&word, value, builtin_order(order));
+}
+
+inline word_type fetch_and(word_type& word, word_type value, std::memory_order order) {
+  return __atomic_fetch_and(&word, value, builtin_order(order));
+}
+
+inline word_type fetch_xor(word_type& word, word_type value, std::memory_order order) {
+  return __atomic_fetch_xor(&word, value, builtin_order(order));
+}
+
+#endif
+
+} // namespace bts::atomics
+
+// Fixed-size bitset whose bits can be tested and modified from many threads at once without locks.
+//
+// Every operation is a single atomic instruction on the word holding the bit, so concurrent writers
+// never lose each other's updates. Words are laid out exactly like in `bitset`: `view()` and `snapshot()`
+// give access to the bits in that form.
+class atomic_bitset {
+public:
+  using word_type = bts::word_type;
+
+public:
+  atomic_bitset() = default;
+
+  // `size` zero bits.
+  explicit atomic_bitset(std::size_t size);
+  explicit atomic_bitset(const bitset::const_view& bits);
+
+  // Leaves `other` empty.
+  atomic_bitset(atomic_bitset&& other) noexcept;
+  atomic_bitset& operator=(atomic_bitset&& other) noexcept;
+
+  std::size_t size() const;
+  std::size_t word_count() const;
+
+  bool test(std::size_t index, std::memory_order order = std::memory_order_seq_cst) const {
+    return (bts::atomics::load(_words[index / bts::word_size], order) & bit_mask(index)) != 0;
+  }
+
+  // These return the previous value of the bit: exactly one of several threads setting the same bit sees false.
+  bool test_and_set(std::size_t index, std::memory_order order = std::memory_order_seq_cst) {
+    return (bts::atomics::fetch_or(_words[index / bts::word_size], bit_mask(index), order) & bit_mask(index)) != 0;
+  }
+
+  bool test_and_reset(std::size_t index, std::memory_order order = std::memory_order_seq_cst) {
+    return (bts::atomics::fetch_and(_words[index / bts::word_size], ~bit_mask(index), order) & bit_mask(index)) != 0;
+  }
+
+  bool test_and_flip(std::size_t index, std::memory_order order = std::memory_order_seq_cst) {
+    return (bts::atomics::fetch_xor(_words[index / bts::word_size], bit_mask(index), order) & bit_mask(index)) != 0;
+  }
+
+  // Whole-word operations on word `index`, holding bits [index * word_size, (index + 1) * word_size) with the
+  // first one in the most significant bit. Bits past the end must stay zero.
+  word_type load_word(std::size_t index, std::memory_order order = std::memory_order_seq_cst) const {
+    return bts::atomics::load(_words[index], order);
+  }
+
+  word_type fetch_or_word(std::size_t index, word_type value, std::memory_order order = std::memory_order_seq_cst) {
+    return bts::atomics::fetch_or(_words[index], value, order);
+  }
+
+  word_type fetch_and_word(std::size_t index, word_type value, std::memory_order order = std::memory_order_seq_cst) {
+    return bts::atomics::fetch_and(_words[index], value, order);
+  }
+
+  // Each word is read atomically, but the result is not a snapshot of one moment if there are
+  // concurrent writers.
+  std::size_t count(std::memory_order order = std::memory_order_relaxed) const;
+
+  // Copy of the bits, read word by word like `count`.
+  bitset snapshot(std::memory_order order = std::memory_order_acquire) const;
+
+  // Plain view of the words, only for use while no thread modifies the bits (e.g. after joining them).
+  bitset::const_view view() const;
+
+private:
+  static word_type bit_mask(std::size_t index) {
+    return word_type(1) << (bts::word_size - 1 - index % bts::word_size);
+  }
+
+private:
+  std::size_t _size = 0;
+  std::unique_ptr<word_type[]> _words;
+};
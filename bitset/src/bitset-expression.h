@@ -0,0 +1,264 @@
+#pragma once
+
+#include "bitset-view.h"
+#include "bts.h"
+
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+// Lazy bitwise expressions over bitset views.
+//
+// `a & b | ~c` builds a tree of small value objects instead of temporary bitsets. Nothing is
+// computed until the expression is converted to a `bitset` or reduced with `count()`, `any()`
+// or `all()`, and then every word is produced in a single pass over the operands.
+//
+// Like views, expressions do not own the bits they refer to: an expression must not outlive
+// the bitsets it was built from.
+
+template <typename Derived>
+class bitset_expression_base {
+public:
+  using word_type = bts::word_type;
+
+  // Marks expression types for the `bitset_expression` concept.
+  using expression_tag = void;
+
+  bool empty() const {
+    return derived().size() == 0;
+  }
+
+  bool operator[](std::size_t index) const {
+    word_type word = derived().word(index / bts::word_size);
+    return (word >> (bts::word_size - index % bts::word_size - 1)) & word_type(1);
+  }
+
+  std::size_t count() const {
+    std::size_t res = 0;
+    for_each_word([&res](std::size_t, word_type word, std::size_t) {
+      res += std::popcount(word);
+      return true;
+    });
+    return res;
+  }
+
+  bool all() const {
+    return for_each_word([](std::size_t, word_type word, std::size_t op_size) {
+      return word == bts::get_subword(bts::word_ones, 0, op_size);
+    });
+  }
+
+  bool any() const {
+    return !for_each_word([](std::size_t, word_type word, std::size_t) { return word == bts::word_zeros; });
+  }
+
+  std::string to_string() const {
+    std::string res(derived().size(), '0');
+    for_each_word([&res](std::size_t index, word_type word, std::size_t op_size) {
+      bts::wtos(word, op_size, res.data() + index * bts::word_size);
+      return true;
+    });
+    return res;
+  }
+
+  // Calls `word_operation(index, word, op_size)` for every word of the result in order, with the
+  // bits past the end of the last word cleared. Stops and returns false as soon as it returns false.
+  template <typename word_operation_type>
+  bool for_each_word(const word_operation_type word_operation) const {
+    const Derived& expression = derived();
+    const std::size_t full_words = expression.size() / bts::word_size;
+    if (expression.aligned()) {
+      for (std::size_t i = 0; i < full_words; ++i) {
+        if (!word_operation(i, expression.aligned_word(i), bts::word_size)) {
+          return false;
+        }
+      }
+    } else {
+      for (std::size_t i = 0; i < full_words; ++i) {
+        if (!word_operation(i, expression.word(i), bts::word_size)) {
+          return false;
+        }
+      }
+    }
+    const std::size_t tail_size = expression.size() % bts::word_size;
+    if (tail_size != 0) {
+      return word_operation(full_words, bts::get_subword(expression.word(full_words), 0, tail_size), tail_size);
+    }
+    return true;
+  }
+
+private:
+  const Derived& derived() const {
+    return static_cast<const Derived&>(*this);
+  }
+};
+
+template <typename T>
+concept bitset_expression = requires { typename T::expression_tag; };
+
+template <typename T>
+concept bitset_operand = bitset_expression<T> || std::convertible_to<const T&, bitset_view<const bts::word_type>>;
+
+// Leaf of an expression: reads the words of a view, shifting them into place if it is unaligned.
+class bitset_view_expression : public bitset_expression_base<bitset_view_expression> {
+public:
+  explicit bitset_view_expression(const bitset_view<const word_type>& view)
+      : _data(view.begin()._current)
+      , _shift(view.begin()._index)
+      , _size(view.size())
+      , _words((_shift + _size + bts::word_size - 1) / bts::word_size) {}
+
+  std::size_t size() const {
+    return _size;
+  }
+
+  bool aligned() const {
+    return _shift == 0;
+  }
+
+  word_type aligned_word(std::size_t index) const {
+    return _data[index];
+  }
+
+  word_type word(std::size_t index) const {
+    if (_shift == 0) {
+      return _data[index];
+    }
+    word_type res = _data[index] << _shift;
+    if (index + 1 < _words) {
+      res |= _data[index + 1] >> (bts::word_size - _shift);
+    }
+    return res;
+  }
+
+private:
+  const word_type* _data;
+  std::size_t _shift;
+  std::size_t _size;
+  std::size_t _words;
+};
+
+template <typename word_operation_type, typename L, typename R>
+class bitset_binary_expression : public bitset_expression_base<bitset_binary_expression<word_operation_type, L, R>> {
+public:
+  using word_type = bts::word_type;
+
+  // Both operands must have the same size.
+  bitset_binary_expression(const L& lhs, const R& rhs)
+      : _lhs(lhs)
+      , _rhs(rhs) {
+    assert(_lhs.size() == _rhs.size());
+  }
+
+  std::size_t size() const {
+    return _lhs.size();
+  }
+
+  bool aligned() const {
+    return _lhs.aligned() && _rhs.aligned();
+  }
+
+  word_type aligned_word(std::size_t index) const {
+    return word_operation_type{}(_lhs.aligned_word(index), _rhs.aligned_word(index));
+  }
+
+  word_type word(std::size_t index) const {
+    return word_operation_type{}(_lhs.word(index), _rhs.word(index));
+  }
+
+private:
+  L _lhs;
+  R _rhs;
+};
+
+template <typename E>
+class bitset_not_expression : public bitset_expression_base<bitset_not_expression<E>> {
+public:
+  using word_type = bts::word_type;
+
+  explicit bitset_not_expression(const E& operand)
+      : _operand(operand) {}
+
+  std::size_t size() const {
+    return _operand.size();
+  }
+
+  bool aligned() const {
+    return _operand.aligned();
+  }
+
+  word_type aligned_word(std::size_t index) const {
+    return ~_operand.aligned_word(index);
+  }
+
+  word_type word(std::size_t index) const {
+    return ~_operand.word(index);
+  }
+
+private:
+  E _operand;
+};
+
+namespace bts {
+
+template <typename T>
+struct expression_of {
+  using type = bitset_view_expression;
+};
+
+template <bitset_expression T>
+struct expression_of<T> {
+  using type = T;
+};
+
+template <typename T>
+using expression_of_t = typename expression_of<T>::type;
+
+} // namespace bts
+
+template <bitset_operand L, bitset_operand R>
+bitset_binary_expression<std::bit_and<>, bts::expression_of_t<L>, bts::expression_of_t<R>> operator&(
+    const L& lhs,
+    const R& rhs
+) {
+  return {bts::expression_of_t<L>(lhs), bts::expression_of_t<R>(rhs)};
+}
+
+template <bitset_operand L, bitset_operand R>
+bitset_binary_expression<std::bit_or<>, bts::expression_of_t<L>, bts::expression_of_t<R>> operator|(
+    const L& lhs,
+    const R& rhs
+) {
+  return {bts::expression_of_t<L>(lhs), bts::expression_of_t<R>(rhs)};
+}
+
+template <bitset_operand L, bitset_operand R>
+bitset_binary_expression<std::bit_xor<>, bts::expression_of_t<L>, bts::expression_of_t<R>> operator^(
+    const L& lhs,
+    const R& rhs
+) {
+  return {bts::expression_of_t<L>(lhs), bts::expression_of_t<R>(rhs)};
+}
+
+template <bitset_operand E>
+bitset_not_expression<bts::expression_of_t<E>> operator~(const E& operand) {
+  return bitset_not_expression<bts::expression_of_t<E>>(bts::expression_of_t<E>(operand));
+}
+
+template <bitset_operand L, bitset_operand R>
+  requires (bitset_expression<L> || bitset_expression<R>)
+bool operator==(const L& lhs, const R& rhs) {
+  bts::expression_of_t<L> lhs_expression(lhs);
+  bts::expression_of_t<R> rhs_expression(rhs);
+  return lhs_expression.size() == rhs_expression.size() && !(lhs_expression ^ rhs_expression).any();
+}
+
+template <bitset_operand L, bitset_operand R>
+  requires (bitset_expression<L> || bitset_expression<R>)
+bool operator!=(const L& lhs, const R& rhs) {
+  return !(lhs == rhs);
+}
@@ -8,6 +8,7 @@
 #include <iterator>
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 template <typename T>
 class bitset_iterator {
@@ -31,6 +32,14 @@ private:
   template <typename R>
   friend class bitset_view;
 
+  friend class bitset_view_expression;
+
+  template <typename R>
+  friend class bitset_word_iterator;
+
+  template <typename R>
+  friend class bitset_word_reference;
+
   bitset_iterator(word_pointer current, size_t index)
       : _current(current)
       , _index(index) {}
@@ -52,6 +61,23 @@ private:
     return (get_high() | next_word.get_low()) & word_mask;
   }
 
+  // Stores the high `size` bits of `value` starting here, leaving every other bit as it was.
+  void set_word(word_type value, size_t size) const
+    requires (!std::is_const_v<T>)
+  {
+    value = bts::get_subword(value, 0, size);
+    if (bts::word_size - _index < size) {
+      *_current = (get_low() << (bts::word_size - _index)) | (value >> _index);
+
+      size_t next_index = (size + _index - bts::word_size);
+      bitset_iterator next_word = {_current + 1, next_index};
+      *(next_word._current) = (next_word.get_high() >> next_index) | (value << (bts::word_size - _index));
+    } else {
+      word_type mask = ~bts::get_subword(bts::word_ones, _index, size);
+      *_current = (value >> _index) | (*_current & mask);
+    }
+  }
+
 public:
   operator bitset_iterator<const T>() const {
     return {_current, _index};
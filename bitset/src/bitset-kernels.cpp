@@ -0,0 +1,389 @@
+#include "bitset-kernels.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define BTS_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace bts::kernels {
+
+namespace {
+
+namespace portable {
+
+void and_words(word_type* dst, const word_type* src, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    dst[i] &= src[i];
+  }
+}
+
+void or_words(word_type* dst, const word_type* src, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    dst[i] |= src[i];
+  }
+}
+
+void xor_words(word_type* dst, const word_type* src, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    dst[i] ^= src[i];
+  }
+}
+
+void andnot_words(word_type* dst, const word_type* src, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    dst[i] &= ~src[i];
+  }
+}
+
+void not_words(word_type* dst, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    dst[i] = ~dst[i];
+  }
+}
+
+std::size_t popcount(const word_type* src, std::size_t count) {
+  std::size_t res = 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    res += std::popcount(src[i]);
+  }
+  return res;
+}
+
+bool all(const word_type* src, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    if (src[i] != word_ones) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool any(const word_type* src, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    if (src[i] != word_zeros) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool equal(const word_type* lhs, const word_type* rhs, std::size_t count) {
+  return count == 0 || std::memcmp(lhs, rhs, count * sizeof(word_type)) == 0;
+}
+
+constexpr kernel_set kernels = {
+    "scalar",
+    and_words,
+    or_words,
+    xor_words,
+    andnot_words,
+    not_words,
+    popcount,
+    all,
+    any,
+    equal,
+};
+
+} // namespace portable
+
+#ifdef BTS_X86_KERNELS
+
+namespace avx2 {
+
+constexpr std::size_t step = sizeof(__m256i) / sizeof(word_type);
+
+#define BTS_AVX2 __attribute__((target("avx2")))
+
+BTS_AVX2 __m256i load(const word_type* src) {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+}
+
+BTS_AVX2 void store(word_type* dst, __m256i value) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), value);
+}
+
+BTS_AVX2 void and_words(word_type* dst, const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm256_and_si256(load(dst + i), load(src + i)));
+  }
+  portable::and_words(dst + i, src + i, count - i);
+}
+
+BTS_AVX2 void or_words(word_type* dst, const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm256_or_si256(load(dst + i), load(src + i)));
+  }
+  portable::or_words(dst + i, src + i, count - i);
+}
+
+BTS_AVX2 void xor_words(word_type* dst, const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm256_xor_si256(load(dst + i), load(src + i)));
+  }
+  portable::xor_words(dst + i, src + i, count - i);
+}
+
+BTS_AVX2 void andnot_words(word_type* dst, const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm256_andnot_si256(load(src + i), load(dst + i)));
+  }
+  portable::andnot_words(dst + i, src + i, count - i);
+}
+
+BTS_AVX2 void not_words(word_type* dst, std::size_t count) {
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm256_xor_si256(load(dst + i), ones));
+  }
+  portable::not_words(dst + i, count - i);
+}
+
+// Nibble lookup table popcount (W. Mula), summed into 64-bit lanes with vpsadbw.
+BTS_AVX2 std::size_t popcount(const word_type* src, std::size_t count) {
+  const __m256i lookup = _mm256_setr_epi8(
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+  );
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  __m256i acc = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    __m256i value = load(src + i);
+    __m256i low = _mm256_and_si256(value, low_mask);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(value, 4), low_mask);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+  }
+  std::size_t res = static_cast<std::size_t>(_mm256_extract_epi64(acc, 0)) +
+                    static_cast<std::size_t>(_mm256_extract_epi64(acc, 1)) +
+                    static_cast<std::size_t>(_mm256_extract_epi64(acc, 2)) +
+                    static_cast<std::size_t>(_mm256_extract_epi64(acc, 3));
+  return res + portable::popcount(src + i, count - i);
+}
+
+BTS_AVX2 bool all(const word_type* src, std::size_t count) {
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    if (!_mm256_testc_si256(load(src + i), ones)) {
+      return false;
+    }
+  }
+  return portable::all(src + i, count - i);
+}
+
+BTS_AVX2 bool any(const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    __m256i value = load(src + i);
+    if (!_mm256_testz_si256(value, value)) {
+      return true;
+    }
+  }
+  return portable::any(src + i, count - i);
+}
+
+BTS_AVX2 bool equal(const word_type* lhs, const word_type* rhs, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    __m256i diff = _mm256_xor_si256(load(lhs + i), load(rhs + i));
+    if (!_mm256_testz_si256(diff, diff)) {
+      return false;
+    }
+  }
+  return portable::equal(lhs + i, rhs + i, count - i);
+}
+
+#undef BTS_AVX2
+
+constexpr kernel_set kernels = {
+    "avx2",
+    and_words,
+    or_words,
+    xor_words,
+    andnot_words,
+    not_words,
+    popcount,
+    all,
+    any,
+    equal,
+};
+
+} // namespace avx2
+
+namespace avx512 {
+
+constexpr std::size_t step = sizeof(__m512i) / sizeof(word_type);
+
+#define BTS_AVX512 __attribute__((target("avx512f,avx512vpopcntdq")))
+
+BTS_AVX512 __m512i load(const word_type* src) {
+  return _mm512_loadu_si512(src);
+}
+
+BTS_AVX512 void store(word_type* dst, __m512i value) {
+  _mm512_storeu_si512(dst, value);
+}
+
+BTS_AVX512 __mmask8 tail_mask(std::size_t count) {
+  return static_cast<__mmask8>((1U << count) - 1);
+}
+
+BTS_AVX512 void and_words(word_type* dst, const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm512_and_si512(load(dst + i), load(src + i)));
+  }
+  portable::and_words(dst + i, src + i, count - i);
+}
+
+BTS_AVX512 void or_words(word_type* dst, const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm512_or_si512(load(dst + i), load(src + i)));
+  }
+  portable::or_words(dst + i, src + i, count - i);
+}
+
+BTS_AVX512 void xor_words(word_type* dst, const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm512_xor_si512(load(dst + i), load(src + i)));
+  }
+  portable::xor_words(dst + i, src + i, count - i);
+}
+
+BTS_AVX512 void andnot_words(word_type* dst, const word_type* src, std::size_t count) {
+  const __m512i ones = _mm512_set1_epi64(-1);
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm512_and_si512(load(dst + i), _mm512_xor_si512(load(src + i), ones)));
+  }
+  portable::andnot_words(dst + i, src + i, count - i);
+}
+
+BTS_AVX512 void not_words(word_type* dst, std::size_t count) {
+  const __m512i ones = _mm512_set1_epi64(-1);
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    store(dst + i, _mm512_xor_si512(load(dst + i), ones));
+  }
+  portable::not_words(dst + i, count - i);
+}
+
+BTS_AVX512 std::size_t popcount(const word_type* src, std::size_t count) {
+  __m512i acc = _mm512_setzero_si512();
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(load(src + i)));
+  }
+  if (i < count) {
+    acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(_mm512_maskz_loadu_epi64(tail_mask(count - i), src + i)));
+  }
+  alignas(sizeof(__m512i)) std::array<word_type, step> lanes;
+  _mm512_store_si512(lanes.data(), acc);
+  std::size_t res = 0;
+  for (word_type lane : lanes) {
+    res += lane;
+  }
+  return res;
+}
+
+BTS_AVX512 bool all(const word_type* src, std::size_t count) {
+  const __m512i ones = _mm512_set1_epi64(-1);
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    if (_mm512_cmpneq_epi64_mask(load(src + i), ones) != 0) {
+      return false;
+    }
+  }
+  return portable::all(src + i, count - i);
+}
+
+BTS_AVX512 bool any(const word_type* src, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    __m512i value = load(src + i);
+    if (_mm512_test_epi64_mask(value, value) != 0) {
+      return true;
+    }
+  }
+  return portable::any(src + i, count - i);
+}
+
+BTS_AVX512 bool equal(const word_type* lhs, const word_type* rhs, std::size_t count) {
+  std::size_t i = 0;
+  for (; i + step <= count; i += step) {
+    if (_mm512_cmpneq_epi64_mask(load(lhs + i), load(rhs + i)) != 0) {
+      return false;
+    }
+  }
+  return portable::equal(lhs + i, rhs + i, count - i);
+}
+
+#undef BTS_AVX512
+
+constexpr kernel_set kernels = {
+    "avx512",
+    and_words,
+    or_words,
+    xor_words,
+    andnot_words,
+    not_words,
+    popcount,
+    all,
+    any,
+    equal,
+};
+
+} // namespace avx512
+
+#endif
+
+struct kernel_registry {
+  std::array<const kernel_set*, 3> sets{};
+  std::size_t size = 0;
+
+  kernel_registry() {
+    sets[size++] = &portable::kernels;
+#ifdef BTS_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      sets[size++] = &avx2::kernels;
+    }
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq")) {
+      sets[size++] = &avx512::kernels;
+    }
+#endif
+  }
+};
+
+const kernel_registry& registry() {
+  static const kernel_registry instance;
+  return instance;
+}
+
+} // namespace
+
+const kernel_set& scalar() {
+  return portable::kernels;
+}
+
+std::span<const kernel_set* const> available() {
+  return {registry().sets.data(), registry().size};
+}
+
+const kernel_set& active() {
+  static const kernel_set& selected = *available().back();
+  return selected;
+}
+
+} // namespace bts::kernels
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "bts.h"
+
+#include <cstddef>
+#include <span>
+
+namespace bts::kernels {
+
+// Bulk operations over whole words. Every kernel set computes exactly the same results,
+// they only differ in the instructions they are allowed to use.
+struct kernel_set {
+  const char* name;
+
+  void (*and_words)(word_type* dst, const word_type* src, std::size_t count);
+  void (*or_words)(word_type* dst, const word_type* src, std::size_t count);
+  void (*xor_words)(word_type* dst, const word_type* src, std::size_t count);
+  // dst = dst & ~src
+  void (*andnot_words)(word_type* dst, const word_type* src, std::size_t count);
+  void (*not_words)(word_type* dst, std::size_t count);
+
+  std::size_t (*popcount)(const word_type* src, std::size_t count);
+  bool (*all)(const word_type* src, std::size_t count);
+  bool (*any)(const word_type* src, std::size_t count);
+  bool (*equal)(const word_type* lhs, const word_type* rhs, std::size_t count);
+};
+
+const kernel_set& scalar();
+
+// Kernel sets supported by the current CPU, starting with the portable one.
+std::span<const kernel_set* const> available();
+
+// The fastest supported kernel set, selected once on first use.
+const kernel_set& active();
+
+} // namespace bts::kernels
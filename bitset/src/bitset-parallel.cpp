@@ -0,0 +1,114 @@
+#include "bitset-parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace bts::parallel {
+
+namespace {
+
+// Equality checks this many words at a time, so that other threads notice a mismatch early.
+constexpr std::size_t equal_step_words = std::size_t(1) << 16;
+
+std::size_t thread_count(const options& opts, std::size_t words) {
+  if (words < opts.serial_threshold_words) {
+    return 1;
+  }
+  std::size_t threads = opts.threads != 0 ? opts.threads : std::thread::hardware_concurrency();
+  return std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(words, 1));
+}
+
+// Calls `range_operation(index, first, count)` for every range of bits of a view of `size` bits whose
+// first bit is `word_offset` bits into its word, one range per thread.
+template <typename range_operation_type>
+void for_each_range(
+    std::size_t size,
+    std::size_t word_offset,
+    std::size_t threads,
+    range_operation_type range_operation
+) {
+  if (threads == 1) {
+    range_operation(0, 0, size);
+    return;
+  }
+  const std::size_t head = (word_size - word_offset) % word_size;
+  const std::size_t words = (size - std::min(size, head) + word_size - 1) / word_size;
+  const std::size_t range_words = (words + threads - 1) / threads;
+
+  auto range_first = [&](std::size_t index) {
+    return index == 0 ? 0 : std::min(size, head + index * range_words * word_size);
+  };
+
+  std::vector<std::thread> workers;
+  auto join_workers = [&workers] {
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  };
+  try {
+    workers.reserve(threads - 1);
+    for (std::size_t i = 1; i < threads; ++i) {
+      workers.emplace_back([&, i] { range_operation(i, range_first(i), range_first(i + 1) - range_first(i)); });
+    }
+    range_operation(0, 0, range_first(1));
+  } catch (...) {
+    // Destroying a joinable thread terminates, so wait for the workers that did start.
+    join_workers();
+    throw;
+  }
+  join_workers();
+}
+
+template <typename operation_type>
+void assign(const bitset::view& dst, const bitset::const_view& src, const options& opts, operation_type operation) {
+  const std::size_t threads = thread_count(opts, dst.size() / word_size);
+  for_each_range(dst.size(), dst.word_offset(), threads, [&](std::size_t, std::size_t first, std::size_t count) {
+    operation(dst.subview(first, count), src.subview(first, count));
+  });
+}
+
+} // namespace
+
+void and_assign(const bitset::view& dst, const bitset::const_view& src, const options& opts) {
+  assign(dst, src, opts, [](const bitset::view& lhs, const bitset::const_view& rhs) { lhs &= rhs; });
+}
+
+void or_assign(const bitset::view& dst, const bitset::const_view& src, const options& opts) {
+  assign(dst, src, opts, [](const bitset::view& lhs, const bitset::const_view& rhs) { lhs |= rhs; });
+}
+
+void xor_assign(const bitset::view& dst, const bitset::const_view& src, const options& opts) {
+  assign(dst, src, opts, [](const bitset::view& lhs, const bitset::const_view& rhs) { lhs ^= rhs; });
+}
+
+std::size_t count(const bitset::const_view& bits, const options& opts) {
+  const std::size_t threads = thread_count(opts, bits.size() / word_size);
+  std::vector<std::size_t> counts(threads, 0);
+  for_each_range(bits.size(), bits.word_offset(), threads, [&](std::size_t i, std::size_t first, std::size_t n) {
+    counts[i] = bits.subview(first, n).count();
+  });
+  return std::accumulate(counts.begin(), counts.end(), std::size_t(0));
+}
+
+bool equal(const bitset::const_view& lhs, const bitset::const_view& rhs, const options& opts) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  const std::size_t threads = thread_count(opts, lhs.size() / word_size);
+  std::atomic<bool> mismatch = false;
+  for_each_range(lhs.size(), lhs.word_offset(), threads, [&](std::size_t, std::size_t first, std::size_t n) {
+    const std::size_t step = equal_step_words * word_size;
+    for (std::size_t pos = first; pos < first + n && !mismatch.load(std::memory_order_relaxed); pos += step) {
+      const std::size_t len = std::min(step, first + n - pos);
+      if (lhs.subview(pos, len) != rhs.subview(pos, len)) {
+        mismatch.store(true, std::memory_order_relaxed);
+      }
+    }
+  });
+  return !mismatch.load();
+}
+
+} // namespace bts::parallel
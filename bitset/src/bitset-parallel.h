@@ -0,0 +1,30 @@
+#pragma once
+
+#include "bitset.h"
+
+#include <cstddef>
+
+// Multi-threaded versions of the bulk operations, for bitsets large enough to be limited by the memory
+// bandwidth of a single core.
+//
+// The bits are split into one contiguous range per thread. Ranges start at word boundaries of the view
+// being written, so no two threads ever touch the same word, and each range goes through the usual
+// single-threaded operation. Views below `serial_threshold_words` are processed on the calling thread:
+// starting threads costs tens of microseconds, which only pays off for megabytes of data.
+namespace bts::parallel {
+
+struct options {
+  // Number of threads to use, including the calling one. Zero means `std::thread::hardware_concurrency()`.
+  std::size_t threads = 0;
+  std::size_t serial_threshold_words = std::size_t(1) << 20;
+};
+
+void and_assign(const bitset::view& dst, const bitset::const_view& src, const options& opts = {});
+void or_assign(const bitset::view& dst, const bitset::const_view& src, const options& opts = {});
+void xor_assign(const bitset::view& dst, const bitset::const_view& src, const options& opts = {});
+
+std::size_t count(const bitset::const_view& bits, const options& opts = {});
+
+bool equal(const bitset::const_view& lhs, const bitset::const_view& rhs, const options& opts = {});
+
+} // namespace bts::parallel
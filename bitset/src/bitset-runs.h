@@ -0,0 +1,80 @@
+#pragma once
+
+#include "bitset-iterator.h"
+
+#include <cstddef>
+#include <iterator>
+
+template <typename T>
+class bitset_view;
+
+// Maximal range `[begin, end)` of consecutive set bits.
+struct bitset_run {
+  std::size_t begin;
+  std::size_t end;
+
+  friend bool operator==(const bitset_run& lhs, const bitset_run& rhs) = default;
+};
+
+// Iterator over the runs of a view, see `bitset_view::runs`. Each step looks for the next set bit and then for
+// the zero after it, both a word at a time.
+template <typename T>
+class bitset_run_iterator {
+public:
+  using value_type = bitset_run;
+  using difference_type = std::ptrdiff_t;
+  using reference = bitset_run;
+  using pointer = void;
+  using iterator_category = std::forward_iterator_tag;
+
+  bitset_run_iterator() = default;
+
+  bitset_run operator*() const {
+    return _run;
+  }
+
+  bitset_run_iterator& operator++() {
+    advance(_run.end);
+    return *this;
+  }
+
+  bitset_run_iterator operator++(int) {
+    bitset_run_iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  friend bool operator==(const bitset_run_iterator& lhs, const bitset_run_iterator& rhs) {
+    return lhs._run == rhs._run;
+  }
+
+private:
+  template <typename R>
+  friend class bitset_view;
+
+  using view_type = bitset_view<const T>;
+
+  // First run starting at or after `from`, the end iterator is the one with an empty run at the end of the bits.
+  bitset_run_iterator(bitset_iterator<const T> first, bitset_iterator<const T> last, std::size_t from)
+      : _first(first)
+      , _last(last) {
+    advance(from);
+  }
+
+  void advance(std::size_t from) {
+    const view_type bits(_first, _last);
+    const std::size_t begin = from < bits.size() ? bits.subview(from).find_first() : view_type::npos;
+    if (begin == view_type::npos) {
+      _run = {bits.size(), bits.size()};
+      return;
+    }
+    const std::size_t length = bits.subview(from + begin).find_first_zero();
+    _run.begin = from + begin;
+    _run.end = length == view_type::npos ? bits.size() : _run.begin + length;
+  }
+
+private:
+  bitset_iterator<const T> _first;
+  bitset_iterator<const T> _last;
+  bitset_run _run{0, 0};
+};
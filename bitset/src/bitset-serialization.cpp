@@ -0,0 +1,179 @@
+#include "bitset-serialization.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+namespace {
+
+using word_type = bts::word_type;
+
+constexpr std::array<char, 4> magic = {'B', 'T', 'S', '\0'};
+constexpr std::uint16_t byte_order_mark = 0x0102;
+constexpr std::uint16_t swapped_byte_order_mark = 0x0201;
+
+// Number of words copied through a buffer at a time when streaming.
+constexpr std::size_t chunk_words = 1024;
+
+struct header {
+  std::array<char, 4> magic;
+  std::uint16_t version;
+  std::uint16_t byte_order;
+  std::uint64_t size;
+  std::uint64_t checksum;
+};
+
+static_assert(sizeof(header) == bts::serialization::header_size);
+static_assert(sizeof(header) % sizeof(word_type) == 0);
+
+std::size_t words_for(std::size_t size) {
+  return size / bts::word_size + (size % bts::word_size != 0 ? 1 : 0);
+}
+
+std::uint64_t byteswap(std::uint64_t value) {
+  std::uint64_t res = 0;
+  for (std::size_t i = 0; i < sizeof(value); ++i) {
+    res = (res << 8) | ((value >> (8 * i)) & 0xff);
+  }
+  return res;
+}
+
+// Word-at-a-time mix, seeded with the size so that bitsets differing only in trailing zeros differ.
+class checksum {
+public:
+  explicit checksum(std::uint64_t size)
+      : _state(size ^ 0x6a09e667f3bcc908) {}
+
+  void update(const word_type* words, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+      _state = std::rotl(_state ^ words[i], 29) * 0x9e3779b97f4a7c15;
+    }
+  }
+
+  std::uint64_t value() const {
+    return _state ^ (_state >> 32);
+  }
+
+private:
+  std::uint64_t _state;
+};
+
+// Calls `flush(words, count)` for consecutive chunks of the words a bitset with the bits of `bs` would store.
+template <typename flush_type>
+void for_each_chunk(const bitset::const_view& bs, flush_type flush) {
+  std::array<word_type, chunk_words> buffer;
+  std::size_t count = 0;
+  bitset_view_expression(bs).for_each_word([&](std::size_t, word_type word, std::size_t) {
+    buffer[count++] = word;
+    if (count == chunk_words) {
+      flush(buffer.data(), count);
+      count = 0;
+    }
+    return true;
+  });
+  if (count != 0) {
+    flush(buffer.data(), count);
+  }
+}
+
+// Returns whether the header was written with the other byte order, with its fields already swapped back.
+bool check_header(header& head) {
+  if (head.magic != magic) {
+    throw bitset_format_error("bitset: bad magic");
+  }
+  bool swapped = false;
+  if (head.byte_order == swapped_byte_order_mark) {
+    swapped = true;
+    head.version = static_cast<std::uint16_t>((head.version >> 8) | (head.version << 8));
+    head.size = byteswap(head.size);
+    head.checksum = byteswap(head.checksum);
+  } else if (head.byte_order != byte_order_mark) {
+    throw bitset_format_error("bitset: bad byte order mark");
+  }
+  if (head.version != bts::serialization::version) {
+    throw bitset_format_error("bitset: unsupported format version");
+  }
+  return swapped;
+}
+
+} // namespace
+
+std::size_t serialized_size(std::size_t size) {
+  return sizeof(header) + words_for(size) * sizeof(word_type);
+}
+
+void serialize(std::ostream& out, const bitset::const_view& bs) {
+  checksum sum(bs.size());
+  for_each_chunk(bs, [&sum](const word_type* words, std::size_t count) { sum.update(words, count); });
+
+  header head{magic, bts::serialization::version, byte_order_mark, bs.size(), sum.value()};
+  out.write(reinterpret_cast<const char*>(&head), sizeof(head));
+  for_each_chunk(bs, [&out](const word_type* words, std::size_t count) {
+    out.write(reinterpret_cast<const char*>(words), static_cast<std::streamsize>(count * sizeof(word_type)));
+  });
+}
+
+bitset deserialize(std::istream& in) {
+  header head;
+  if (!in.read(reinterpret_cast<char*>(&head), sizeof(head))) {
+    throw bitset_format_error("bitset: truncated header");
+  }
+  const bool swapped = check_header(head);
+
+  // Reading chunk by chunk also keeps a corrupted size from allocating more than the stream holds.
+  bitset res;
+  checksum sum(head.size);
+  std::array<word_type, chunk_words> buffer;
+  const std::size_t words = words_for(head.size);
+  for (std::size_t first = 0; first < words; first += chunk_words) {
+    const std::size_t count = std::min(words - first, chunk_words);
+    if (!in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(count * sizeof(word_type)))) {
+      throw bitset_format_error("bitset: truncated data");
+    }
+    if (swapped) {
+      for (std::size_t i = 0; i < count; ++i) {
+        buffer[i] = byteswap(buffer[i]);
+      }
+    }
+    sum.update(buffer.data(), count);
+
+    const std::size_t pos = first * bts::word_size;
+    const std::size_t bits = std::min(static_cast<std::size_t>(head.size) - pos, count * bts::word_size);
+    res.resize(pos + bits);
+    res.subview(pos) |= bitset::const_view(buffer.data(), bits);
+  }
+  if (sum.value() != head.checksum) {
+    throw bitset_format_error("bitset: checksum mismatch");
+  }
+  return res;
+}
+
+bitset::const_view view_serialized(std::span<const std::byte> region, bool verify_checksum) {
+  header head;
+  if (region.size() < sizeof(head)) {
+    throw bitset_format_error("bitset: truncated header");
+  }
+  std::memcpy(&head, region.data(), sizeof(head));
+  if (check_header(head)) {
+    throw bitset_format_error("bitset: cannot view data written with a different byte order");
+  }
+  if ((region.size() - sizeof(head)) / sizeof(word_type) < words_for(head.size)) {
+    throw bitset_format_error("bitset: truncated data");
+  }
+  if (reinterpret_cast<std::uintptr_t>(region.data()) % alignof(word_type) != 0) {
+    throw bitset_format_error("bitset: data is not aligned to words");
+  }
+
+  const auto* words = reinterpret_cast<const word_type*>(region.data() + sizeof(head));
+  if (verify_checksum) {
+    checksum sum(head.size);
+    sum.update(words, words_for(head.size));
+    if (sum.value() != head.checksum) {
+      throw bitset_format_error("bitset: checksum mismatch");
+    }
+  }
+  return {words, static_cast<std::size_t>(head.size)};
+}
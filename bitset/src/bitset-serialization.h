@@ -0,0 +1,54 @@
+#pragma once
+
+#include "bitset.h"
+#include "bts.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <stdexcept>
+
+// Compact binary format for bitsets.
+//
+// A serialized bitset is a 24-byte header followed by the words of the bitset exactly as `bitset` stores
+// them: bit `i` is bit `63 - i % 64` of word `i / 64`, and the unused bits of the last word are zero.
+// The header holds
+//   - 4 bytes of magic, "BTS\0",
+//   - `uint16_t` format version,
+//   - `uint16_t` byte order mark `0x0102`, written in the byte order of the writer,
+//   - `uint64_t` number of bits,
+//   - `uint64_t` checksum of the words.
+// All integers, including the words, use the byte order of the writer. Files written on a machine
+// with the other byte order are still read by `deserialize`, but cannot be viewed in place.
+//
+// The header is a multiple of the word size, so the words of a serialized bitset that starts at a
+// word-aligned address (e.g. the start of a memory-mapped file) can be used directly by a view.
+
+class bitset_format_error : public std::runtime_error {
+public:
+  using std::runtime_error::runtime_error;
+};
+
+namespace bts::serialization {
+
+constexpr std::uint16_t version = 1;
+constexpr std::size_t header_size = 24;
+
+} // namespace bts::serialization
+
+// Number of bytes `serialize` writes for a bitset of `size` bits.
+std::size_t serialized_size(std::size_t size);
+
+void serialize(std::ostream& out, const bitset::const_view& bs);
+
+// Throws `bitset_format_error` if the data is malformed or does not match its checksum.
+bitset deserialize(std::istream& in);
+
+// View over the bits of a serialized bitset stored in `region`, without copying. The view is valid as long
+// as `region` is. Only the header is read unless `verify_checksum` is set, so a large memory-mapped file
+// is not touched until its bits are used.
+//
+// Throws `bitset_format_error` if the header is malformed, `region` is too short or not aligned for words,
+// or the bitset was written with a different byte order.
+bitset::const_view view_serialized(std::span<const std::byte> region, bool verify_checksum = false);
@@ -1,17 +1,24 @@
 #pragma once
 
 #include "bitset-iterator.h"
+#include "bitset-kernels.h"
 #include "bitset-reference.h"
+#include "bitset-runs.h"
+#include "bitset-words.h"
 #include "bts.h"
 
 #include <algorithm>
 #include <bit>
+#include <charconv>
 #include <concepts>
+#include <cstdint>
 #include <functional>
 #include <numeric>
 #include <ranges>
+#include <span>
 #include <sstream>
 #include <string>
+#include <system_error>
 #include <utility>
 
 template <typename T>
@@ -25,6 +32,10 @@ public:
   using const_reference = bitset_reference<const word_type>;
   using view = bitset_view<word_type>;
   using const_view = bitset_view<const word_type>;
+  using word_iterator = bitset_word_iterator<word_type>;
+  using word_range = std::ranges::subrange<word_iterator>;
+  using run_iterator = bitset_run_iterator<std::remove_const_t<word_type>>;
+  using run_range = std::ranges::subrange<run_iterator>;
 
 public:
   static constexpr std::size_t npos = -1;
@@ -35,6 +46,11 @@ public:
       : _begin(begin)
       , _end(end) {}
 
+  // View of the first `size` bits of `words`, laid out the same way `bitset` stores them.
+  bitset_view(word_type* words, std::size_t size)
+      : _begin(words, 0)
+      , _end(_begin + size) {}
+
   void swap(view& other) noexcept {
     std::swap(_begin, other._begin);
     std::swap(_end, other._end);
@@ -52,6 +68,12 @@ public:
     return end() - begin();
   }
 
+  // Position of the first bit inside its memory word. Subviews starting `word_size - word_offset()` bits
+  // in, plus any multiple of `word_size`, begin at a word boundary and share no words with the bits before.
+  std::size_t word_offset() const {
+    return _begin._index;
+  }
+
   iterator begin() const {
     return _begin;
   }
@@ -64,10 +86,18 @@ public:
     return begin()[index];
   }
 
+  // The bits as `word_size`-bit words, shifted into alignment if the view starts mid-word: word `i` holds bits
+  // `[i * word_size, (i + 1) * word_size)` with the first one in the most significant position. The last word
+  // has the bits past the end of the view zeroed, and writing it leaves those bits untouched.
+  word_range words() const {
+    const auto count = static_cast<std::ptrdiff_t>((size() + bts::word_size - 1) / bts::word_size);
+    return {word_iterator(_begin, size(), 0), word_iterator(_begin, size(), count)};
+  }
+
   view operator&=(const const_view& other) const
     requires (!std::is_const_v<T>)
   {
-    return apply_operation(other, [](word_type& a, word_type b, size_t op_size) {
+    return apply_bulk_operation(other, &kernel_set::and_words, [](word_type& a, word_type b, size_t op_size) {
       bts::set_subword(a, a & b, 0, op_size);
       return true;
     });
@@ -76,7 +106,7 @@ public:
   view operator|=(const const_view& other) const
     requires (!std::is_const_v<T>)
   {
-    return apply_operation(other, [](word_type& a, word_type b, size_t op_size) {
+    return apply_bulk_operation(other, &kernel_set::or_words, [](word_type& a, word_type b, size_t op_size) {
       bts::set_subword(a, a | b, 0, op_size);
       return true;
     });
@@ -85,7 +115,7 @@ public:
   view operator^=(const const_view& other) const
     requires (!std::is_const_v<T>)
   {
-    return apply_operation(other, [](word_type& a, word_type b, size_t op_size) {
+    return apply_bulk_operation(other, &kernel_set::xor_words, [](word_type& a, word_type b, size_t op_size) {
       bts::set_subword(a, a ^ b, 0, op_size);
       return true;
     });
@@ -94,10 +124,14 @@ public:
   view flip() const
     requires (!std::is_const_v<T>)
   {
-    return apply_operation(*this, [](word_type& a, word_type, size_t op_size) {
+    std::size_t words = aligned_words(*this);
+    bts::kernels::active().not_words(begin()._current, words);
+    view tail = subview(words * bts::word_size);
+    tail.apply_operation(tail, [](word_type& a, word_type, size_t op_size) {
       bts::set_subword(a, ~a, 0, op_size);
       return true;
     });
+    return *this;
   }
 
   view set() const
@@ -118,9 +152,25 @@ public:
     });
   }
 
+  // Moves every bit `count` positions towards the beginning, the last `count` bits become zeros.
+  view shift_left_inplace(std::size_t count) const
+    requires (!std::is_const_v<T>)
+  {
+    return shift_inplace(static_cast<std::ptrdiff_t>(std::min(count, size())));
+  }
+
+  // Moves every bit `count` positions towards the end, the first `count` bits become zeros.
+  view shift_right_inplace(std::size_t count) const
+    requires (!std::is_const_v<T>)
+  {
+    return shift_inplace(-static_cast<std::ptrdiff_t>(std::min(count, size())));
+  }
+
   std::size_t count() const {
-    std::size_t res = 0;
-    apply_operation<false>(*this, [&res](const word_type&, word_type b, size_t op_size) {
+    std::size_t words = aligned_words(*this);
+    std::size_t res = bts::kernels::active().popcount(begin()._current, words);
+    view tail = subview(words * bts::word_size);
+    tail.apply_operation<false>(tail, [&res](const word_type&, word_type b, size_t op_size) {
       res += std::popcount((bts::get_subword(b, 0, op_size)));
       return true;
     });
@@ -128,8 +178,13 @@ public:
   }
 
   bool all() const {
+    std::size_t words = aligned_words(*this);
+    if (!bts::kernels::active().all(begin()._current, words)) {
+      return false;
+    }
     bool res = true;
-    apply_operation<false>(*this, [&res](const word_type&, word_type b, size_t op_size) {
+    view tail = subview(words * bts::word_size);
+    tail.apply_operation<false>(tail, [&res](const word_type&, word_type b, size_t op_size) {
       res &= bts::get_subword(b, 0, op_size) == bts::get_subword(bts::word_ones, 0, op_size);
       return res;
     });
@@ -137,8 +192,13 @@ public:
   }
 
   bool any() const {
+    std::size_t words = aligned_words(*this);
+    if (bts::kernels::active().any(begin()._current, words)) {
+      return true;
+    }
     bool res = false;
-    apply_operation<false>(*this, [&res](const word_type&, word_type b, size_t op_size) {
+    view tail = subview(words * bts::word_size);
+    tail.apply_operation<false>(tail, [&res](const word_type&, word_type b, size_t op_size) {
       res |= bts::get_subword(b, 0, op_size) > 0;
       return !res;
     });
@@ -149,22 +209,180 @@ public:
     return size() == 0;
   }
 
+  // Index of the first set bit, or npos if there is none.
+  std::size_t find_first() const {
+    return find_first_word([](word_type word) { return word; });
+  }
+
+  // Index of the first set bit after `pos`, or npos if there is none.
+  std::size_t find_next(std::size_t pos) const {
+    if (pos == npos || pos + 1 >= size()) {
+      return npos;
+    }
+    std::size_t res = subview(pos + 1).find_first();
+    return res == npos ? npos : res + pos + 1;
+  }
+
+  // Index of the last set bit, or npos if there is none.
+  std::size_t find_last() const {
+    for (std::size_t end = size(); end > 0;) {
+      std::size_t start = (end - 1) / bts::word_size * bts::word_size;
+      word_type word = (begin() + start).get_word(end - start);
+      if (word != bts::word_zeros) {
+        return start + bts::word_size - 1 - std::countr_zero(word);
+      }
+      end = start;
+    }
+    return npos;
+  }
+
+  // Index of the first unset bit, or npos if there is none.
+  std::size_t find_first_zero() const {
+    return find_first_word([](word_type word) { return ~word; });
+  }
+
+  // Calls `visitor(index)` for every set bit in increasing order of index.
+  template <typename visitor_type>
+  void for_each_set(visitor_type visitor) const {
+    std::size_t offset = 0;
+    apply_operation<false>(*this, [&](const word_type&, word_type b, size_t op_size) {
+      bts::word_type word = bts::get_subword(b, 0, op_size);
+      while (word != bts::word_zeros) {
+        std::size_t index = std::countl_zero(word);
+        visitor(offset + index);
+        word ^= bts::word_type(1) << (bts::word_size - 1 - index);
+      }
+      offset += bts::word_size;
+      return true;
+    });
+  }
+
+  // Calls `visitor(begin, end)` for every maximal range of set bits in increasing order. Transitions are found
+  // with countl_zero and countl_one on whole words, so long runs and long gaps cost one step per word.
+  template <typename visitor_type>
+  void for_each_run(visitor_type visitor) const {
+    std::size_t offset = 0;
+    std::size_t run_begin = npos;
+    apply_operation<false>(*this, [&](const word_type&, word_type b, size_t op_size) {
+      const bts::word_type word = bts::get_subword(b, 0, op_size);
+      for (std::size_t pos = 0; pos < op_size;) {
+        if (run_begin == npos) {
+          pos += std::countl_zero(word << pos);
+          if (pos >= op_size) {
+            break;
+          }
+          run_begin = offset + pos;
+        } else {
+          pos += std::countl_one(word << pos);
+          if (pos >= op_size) {
+            break;
+          }
+          visitor(run_begin, offset + pos);
+          run_begin = npos;
+        }
+      }
+      offset += bts::word_size;
+      return true;
+    });
+    if (run_begin != npos) {
+      visitor(run_begin, size());
+    }
+  }
+
+  // The maximal ranges of set bits as `bitset_run`s, found lazily in increasing order.
+  run_range runs() const {
+    return {run_iterator(_begin, _end, 0), run_iterator(_begin, _end, size())};
+  }
+
+  // Sets every bit of the given ranges, which may overlap and come in any order, filling whole words at once.
+  void set_runs(std::span<const bitset_run> runs) const
+    requires (!std::is_const_v<T>)
+  {
+    for (const bitset_run& run : runs) {
+      subview(run.begin, run.end - run.begin).set();
+    }
+  }
+
+  // Bulk versions of `(*this)[i] = true` and `(*this)[i] = false` for every index. Indices may repeat and
+  // come in any order. Sorted ones are merged into a single write per word, others are prefetched ahead.
+  void set_bits(std::span<const std::uint32_t> indices) const
+    requires (!std::is_const_v<T>)
+  {
+    update_bits(indices, [](word_type& word, bts::word_type mask) { word |= mask; });
+  }
+
+  void reset_bits(std::span<const std::uint32_t> indices) const
+    requires (!std::is_const_v<T>)
+  {
+    update_bits(indices, [](word_type& word, bts::word_type mask) { word &= ~mask; });
+  }
+
+  // Writes `(*this)[indices[i]]` to `out[i]`, `out` must be at least as long as `indices`.
+  void test_bits(std::span<const std::uint32_t> indices, std::span<bool> out) const {
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+      prefetch_bit<0>(indices, i + prefetch_distance);
+      out[i] = test_bit(indices[i]);
+    }
+  }
+
+  // Packs `(*this)[indices[i]]` into bit `i` of `out`, a word at a time. `out` must be at least as long as `indices`.
+  void gather(std::span<const std::uint32_t> indices, const bitset_view<bts::word_type>& out) const {
+    for (std::size_t first = 0; first < indices.size(); first += bts::word_size) {
+      const std::size_t op_size = std::min(indices.size() - first, bts::word_size);
+      bts::word_type packed = bts::word_zeros;
+      for (std::size_t i = 0; i < op_size; ++i) {
+        prefetch_bit<0>(indices, first + i + prefetch_distance);
+        packed |= bts::word_type(test_bit(indices[first + i])) << (bts::word_size - 1 - i);
+      }
+      out.update_bitset_word(out.begin() + first, packed, op_size);
+    }
+  }
+
   friend std::ostream& operator<<(std::ostream& out, const bitset_view& bs) {
-    for (auto it : bs) {
-      out << it;
+    constexpr std::size_t chunk_size = 4096;
+    char buffer[chunk_size];
+    for (std::size_t pos = 0; pos < bs.size(); pos += chunk_size) {
+      const char* end = bs.subview(pos, chunk_size).to_chars(buffer, buffer + chunk_size).ptr;
+      out.write(buffer, end - buffer);
     }
     return out;
   }
 
   std::string to_string() const {
-    std::string res;
-    res.reserve(size());
-    for (auto it : *this) {
-      res += it ? '1' : '0';
-    }
+    std::string res(size(), '0');
+    to_chars(res.data(), res.data() + res.size());
     return res;
   }
 
+  // Writes the bits as '0' and '1' characters to [first, last), a whole word at a time.
+  // Fails with `value_too_large` if the buffer is shorter than the view.
+  std::to_chars_result to_chars(char* first, char* last) const {
+    if (static_cast<std::size_t>(last - first) < size()) {
+      return {last, std::errc::value_too_large};
+    }
+    for (std::size_t pos = 0; pos < size(); pos += bts::word_size) {
+      const std::size_t op_size = std::min(size() - pos, bts::word_size);
+      bts::wtos((begin() + pos).get_word(op_size), op_size, first + pos);
+    }
+    return {first + size(), std::errc()};
+  }
+
+  // Reads exactly `size()` '0' and '1' characters from [first, last). If there are fewer, fails with
+  // `invalid_argument` pointing at the first character that is not a binary digit and leaves the view unchanged.
+  std::from_chars_result from_chars(const char* first, const char* last) const
+    requires (!std::is_const_v<T>)
+  {
+    const std::size_t digits = bts::binary_prefix({first, std::min(static_cast<std::size_t>(last - first), size())});
+    if (digits < size()) {
+      return {first + digits, std::errc::invalid_argument};
+    }
+    for (std::size_t pos = 0; pos < size(); pos += bts::word_size) {
+      const std::size_t op_size = std::min(size() - pos, bts::word_size);
+      update_bitset_word(begin() + pos, bts::stow({first + pos, op_size}), op_size);
+    }
+    return {first + size(), std::errc()};
+  }
+
   view subview(std::size_t offset = 0, std::size_t count = npos) const {
     if (size() <= offset) {
       return {end(), end()};
@@ -175,12 +393,108 @@ public:
 private:
   friend class bitset;
 
+  template <typename R>
+  friend class bitset_view;
+
+  using kernel_set = bts::kernels::kernel_set;
+
+  // How many indices ahead of the current one the bulk index operations prefetch.
+  static constexpr std::size_t prefetch_distance = 16;
+
+  static bts::word_type bit_mask(std::size_t pos) {
+    return bts::word_type(1) << (bts::word_size - 1 - pos % bts::word_size);
+  }
+
+  bool test_bit(std::size_t index) const {
+    const std::size_t pos = _begin._index + index;
+    return (_begin._current[pos / bts::word_size] & bit_mask(pos)) != 0;
+  }
+
+  template <int rw>
+  void prefetch_bit(std::span<const std::uint32_t> indices, std::size_t i) const {
+    if (i < indices.size()) {
+      bts::prefetch<rw>(_begin._current + (_begin._index + indices[i]) / bts::word_size);
+    }
+  }
+
+  template <typename update_type>
+  void update_bits(std::span<const std::uint32_t> indices, const update_type update) const {
+    const std::size_t offset = _begin._index;
+    if (std::is_sorted(indices.begin(), indices.end())) {
+      for (std::size_t i = 0; i < indices.size();) {
+        const std::size_t word = (offset + indices[i]) / bts::word_size;
+        bts::word_type mask = bts::word_zeros;
+        for (; i < indices.size() && (offset + indices[i]) / bts::word_size == word; ++i) {
+          mask |= bit_mask(offset + indices[i]);
+        }
+        update(_begin._current[word], mask);
+      }
+      return;
+    }
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+      prefetch_bit<1>(indices, i + prefetch_distance);
+      const std::size_t pos = offset + indices[i];
+      update(_begin._current[pos / bts::word_size], bit_mask(pos));
+    }
+  }
+
+  // Number of leading whole words that can be handed to a bulk kernel: zero unless both views are word-aligned.
+  std::size_t aligned_words(const const_view& other) const {
+    if (_begin._index != 0 || other._begin._index != 0) {
+      return 0;
+    }
+    return other.size() / bts::word_size;
+  }
+
+  // Bits are stored starting from the most significant one, so the first bit of interest in a word is found
+  // with countl_zero. `transform` selects the bits to look for, whole zero words are skipped.
+  template <typename transform_type>
+  std::size_t find_first_word(const transform_type transform) const {
+    std::size_t res = npos;
+    std::size_t offset = 0;
+    apply_operation<false>(*this, [&](const word_type&, word_type b, size_t op_size) {
+      word_type word = bts::get_subword(transform(b), 0, op_size);
+      if (word != bts::word_zeros) {
+        res = offset + std::countl_zero(word);
+        return false;
+      }
+      offset += bts::word_size;
+      return true;
+    });
+    return res;
+  }
+
+  // Runs the active kernel over the aligned prefix and `word_operation` over whatever is left.
+  template <typename word_operation_type>
+  view apply_bulk_operation(
+      const const_view& other,
+      void (*kernel_set::*bulk_operation)(word_type*, const word_type*, std::size_t),
+      const word_operation_type word_operation
+  ) const {
+    std::size_t words = aligned_words(other);
+    (bts::kernels::active().*bulk_operation)(begin()._current, other.begin()._current, words);
+    subview(words * bts::word_size).apply_operation(other.subview(words * bts::word_size), word_operation);
+    return *this;
+  }
+
   template <bool changeable = true, typename word_operation_type>
   view apply_operation(const const_view& other, const word_operation_type word_operation) const {
     if (!other.empty()) {
       auto it = begin();
       auto r_it = other.begin();
-      for (std::size_t i = 0; i * bts::word_size < other.size(); it += bts::word_size, r_it += bts::word_size, ++i) {
+      std::size_t i = 0;
+      if (it._index == 0 && r_it._index == 0) {
+        // Both views start on a word boundary, so whole words need no shifting or masking.
+        const std::size_t full_words = other.size() / bts::word_size;
+        for (; i < full_words; ++i) {
+          if (!word_operation(it._current[i], r_it._current[i], bts::word_size)) {
+            return *this;
+          }
+        }
+        it += full_words * bts::word_size;
+        r_it += full_words * bts::word_size;
+      }
+      for (; i * bts::word_size < other.size(); it += bts::word_size, r_it += bts::word_size, ++i) {
         size_t operation_size = std::min(other.size() - i * bts::word_size, bts::word_size);
         word_type tmp = it.get_word(operation_size);
         if (!word_operation(tmp, r_it.get_word(operation_size), operation_size)) {
@@ -194,19 +508,54 @@ private:
     return *this;
   }
 
-  void update_bitset_word(iterator it, word_type value, size_t op_size) const
+  // `size` bits starting at `pos`, aligned to the top of the word. Positions outside of the view read as zeros.
+  bts::word_type shifted_window(std::ptrdiff_t pos, std::size_t size) const {
+    const auto view_size = static_cast<std::ptrdiff_t>(this->size());
+    const auto end = pos + static_cast<std::ptrdiff_t>(size);
+    if (pos >= view_size || end <= 0) {
+      return bts::word_zeros;
+    }
+    if (pos < 0) {
+      return shifted_window(0, static_cast<std::size_t>(end)) >> static_cast<std::size_t>(-pos);
+    }
+    return (begin() + pos).get_word(static_cast<std::size_t>(std::min(end, view_size) - pos));
+  }
+
+  // Every word of the view is rebuilt from the bits `distance` positions further along in one funnel-shift
+  // pass, going in the direction that never overwrites a bit before it has been read.
+  view shift_inplace(std::ptrdiff_t distance) const
     requires (!std::is_const_v<T>)
   {
-    if (bts::word_size - it._index < op_size) {
-      *(it._current) = (it.get_low() << (bts::word_size - it._index)) | (value >> it._index);
-
-      size_t next_index = (op_size + it._index - bts::word_size);
-      bitset_iterator next_word = {it._current + 1, next_index};
-      *(next_word._current) = (next_word.get_high() >> next_index) | (value << (bts::word_size - it._index));
+    if (distance == 0) {
+      return *this;
+    }
+    const std::size_t words = (size() + bts::word_size - 1) / bts::word_size;
+    auto shift_word = [&](std::size_t i) {
+      const std::size_t op_size = std::min(size() - i * bts::word_size, bts::word_size);
+      const auto pos = static_cast<std::ptrdiff_t>(i * bts::word_size);
+      bts::word_type value = shifted_window(pos + distance, op_size);
+      if (_begin._index == 0) {
+        bts::set_subword(_begin._current[i], value, 0, op_size);
+      } else {
+        update_bitset_word(begin() + pos, value, op_size);
+      }
+    };
+    if (distance > 0) {
+      for (std::size_t i = 0; i < words; ++i) {
+        shift_word(i);
+      }
     } else {
-      word_type mask = ~bts::get_subword(bts::word_ones, it._index, op_size);
-      *(it._current) = (value >> it._index) | (*(it._current) & mask);
+      for (std::size_t i = words; i-- > 0;) {
+        shift_word(i);
+      }
     }
+    return *this;
+  }
+
+  void update_bitset_word(iterator it, word_type value, size_t op_size) const
+    requires (!std::is_const_v<T>)
+  {
+    it.set_word(value, op_size);
   }
 
 private:
@@ -218,3 +567,12 @@ template <typename T>
 std::string to_string(const bitset_view<T>& bs) {
   return bs.to_string();
 }
+
+template <typename T>
+std::to_chars_result to_chars(char* first, char* last, const bitset_view<T>& bs) {
+  return bs.to_chars(first, last);
+}
+
+inline std::from_chars_result from_chars(const char* first, const char* last, const bitset_view<bts::word_type>& bs) {
+  return bs.from_chars(first, last);
+}
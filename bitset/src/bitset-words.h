@@ -0,0 +1,170 @@
+#pragma once
+
+#include "bitset-iterator.h"
+#include "bts.h"
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+// Proxy for a word of a mutable `bitset_view`, which may span two memory words of the underlying storage.
+template <typename T>
+class bitset_word_reference {
+public:
+  using word_type = std::remove_const_t<T>;
+
+  bitset_word_reference(const bitset_word_reference&) = default;
+
+  operator word_type() const {
+    return _first.get_word(_size);
+  }
+
+  // Number of bits of the view this word covers, `word_size` for all but the last one.
+  std::size_t size() const {
+    return _size;
+  }
+
+  const bitset_word_reference& operator=(word_type value) const {
+    _first.set_word(value, _size);
+    return *this;
+  }
+
+  const bitset_word_reference& operator=(const bitset_word_reference& other) const {
+    return *this = word_type(other);
+  }
+
+  const bitset_word_reference& operator&=(word_type value) const {
+    return *this = word_type(*this) & value;
+  }
+
+  const bitset_word_reference& operator|=(word_type value) const {
+    return *this = word_type(*this) | value;
+  }
+
+  const bitset_word_reference& operator^=(word_type value) const {
+    return *this = word_type(*this) ^ value;
+  }
+
+private:
+  template <typename R>
+  friend class bitset_word_iterator;
+
+  bitset_word_reference(bitset_iterator<T> first, std::size_t size)
+      : _first(first)
+      , _size(size) {}
+
+private:
+  bitset_iterator<T> _first;
+  std::size_t _size;
+};
+
+// Iterator over the words of a `bitset_view`, see `bitset_view::words`. Dereferencing a const one
+// yields the word by value.
+template <typename T>
+class bitset_word_iterator {
+public:
+  using value_type = std::remove_const_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::conditional_t<std::is_const_v<T>, value_type, bitset_word_reference<T>>;
+  using pointer = void;
+  using iterator_category = std::random_access_iterator_tag;
+
+  bitset_word_iterator() = default;
+
+  operator bitset_word_iterator<const T>() const {
+    return {_first, _size, _index};
+  }
+
+  reference operator*() const {
+    const std::size_t pos = static_cast<std::size_t>(_index) * bts::word_size;
+    const std::size_t size = std::min(_size - pos, bts::word_size);
+    if constexpr (std::is_const_v<T>) {
+      return (_first + pos).get_word(size);
+    } else {
+      return {_first + pos, size};
+    }
+  }
+
+  reference operator[](difference_type n) const {
+    return *(*this + n);
+  }
+
+  bitset_word_iterator& operator++() {
+    ++_index;
+    return *this;
+  }
+
+  bitset_word_iterator operator++(int) {
+    bitset_word_iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  bitset_word_iterator& operator--() {
+    --_index;
+    return *this;
+  }
+
+  bitset_word_iterator operator--(int) {
+    bitset_word_iterator tmp = *this;
+    --*this;
+    return tmp;
+  }
+
+  bitset_word_iterator& operator+=(difference_type n) {
+    _index += n;
+    return *this;
+  }
+
+  bitset_word_iterator& operator-=(difference_type n) {
+    _index -= n;
+    return *this;
+  }
+
+  friend bitset_word_iterator operator+(const bitset_word_iterator& a, difference_type n) {
+    bitset_word_iterator res = a;
+    res += n;
+    return res;
+  }
+
+  friend bitset_word_iterator operator+(difference_type n, const bitset_word_iterator& a) {
+    return a + n;
+  }
+
+  friend bitset_word_iterator operator-(const bitset_word_iterator& a, difference_type n) {
+    bitset_word_iterator res = a;
+    res -= n;
+    return res;
+  }
+
+  friend difference_type operator-(const bitset_word_iterator& lhs, const bitset_word_iterator& rhs) {
+    return lhs._index - rhs._index;
+  }
+
+  friend bool operator==(const bitset_word_iterator& lhs, const bitset_word_iterator& rhs) {
+    return lhs._index == rhs._index;
+  }
+
+  friend std::strong_ordering operator<=>(const bitset_word_iterator& lhs, const bitset_word_iterator& rhs) {
+    return lhs._index <=> rhs._index;
+  }
+
+private:
+  template <typename R>
+  friend class bitset_view;
+
+  template <typename R>
+  friend class bitset_word_iterator;
+
+  bitset_word_iterator(bitset_iterator<T> first, std::size_t size, difference_type index)
+      : _first(first)
+      , _size(size)
+      , _index(index) {}
+
+private:
+  bitset_iterator<T> _first;
+  std::size_t _size = 0;
+  difference_type _index = 0;
+};
@@ -1,11 +1,14 @@
 #include "bitset.h"
 
-bitset::bitset(std::size_t size, bool value)
-    : bitset(size) {
+bitset::bitset(std::size_t size, bool value, std::pmr::memory_resource* resource)
+    : bitset(size, resource) {
   word_type word_value = (value ? bts::word_ones : bts::word_zeros);
-  for (size_t i = 0; i < size_in_words(); i++) {
-    new (_data + i) word_type(word_value);
-  }
+  std::uninitialized_fill_n(data(), size_in_words(), word_value);
+}
+
+bitset::bitset(std::size_t size, std::span<const bitset_run> runs, std::pmr::memory_resource* resource)
+    : bitset(size, false, resource) {
+  view(*this).set_runs(runs);
 }
 
 void bitset::flip() & {
@@ -17,17 +20,69 @@ std::size_t bitset::size() const {
 }
 
 size_t bitset::size_in_words() const {
-  return (size() + bts::word_size - 1) / bts::word_size;
+  return words_for(size());
+}
+
+size_t bitset::words_for(std::size_t size) {
+  return (size + bts::word_size - 1) / bts::word_size;
+}
+
+std::size_t bitset::capacity() const {
+  return _capacity * bts::word_size;
+}
+
+void bitset::reserve(std::size_t size) {
+  std::size_t words = words_for(size);
+  if (words <= _capacity) {
+    return;
+  }
+  word_pointer new_data = allocate(words);
+  std::uninitialized_copy_n(data(), size_in_words(), new_data);
+  std::destroy_n(data(), size_in_words());
+  deallocate();
+  _storage.dynamic_data = new_data;
+  _capacity = words;
+}
+
+void bitset::resize(std::size_t size, bool value) {
+  std::size_t old_size = this->size();
+  std::size_t old_words = size_in_words();
+  if (size <= old_size) {
+    std::destroy_n(data() + words_for(size), old_words - words_for(size));
+    _size = size;
+    return;
+  }
+  if (size > capacity()) {
+    reserve(std::max(size, 2 * capacity()));
+  }
+  std::uninitialized_fill_n(data() + old_words, words_for(size) - old_words, value ? bts::word_ones : bts::word_zeros);
+  _size = size;
+  view old_tail = subview(old_size, old_words * bts::word_size - old_size);
+  if (value) {
+    old_tail.set();
+  } else {
+    old_tail.reset();
+  }
+}
+
+void bitset::push_back(bool value) {
+  resize(size() + 1, value);
 }
 
 bitset::~bitset() {
   clear();
-  operator delete(_data);
+  deallocate();
 }
 
 void bitset::swap(bitset& other) noexcept {
-  std::swap(_data, other._data);
   std::swap(_size, other._size);
+  std::swap(_capacity, other._capacity);
+  std::swap(_storage, other._storage);
+  std::swap(_resource, other._resource);
+}
+
+std::pmr::memory_resource* bitset::get_memory_resource() const {
+  return _resource;
 }
 
 bool bitset::empty() const {
@@ -39,7 +94,7 @@ bitset::reference bitset::operator[](std::size_t index) {
 }
 
 bitset::iterator bitset::begin() {
-  return {_data, size_t(0)};
+  return {data(), size_t(0)};
 }
 
 bitset::const_reference bitset::operator[](std::size_t index) const {
@@ -47,7 +102,7 @@ bitset::const_reference bitset::operator[](std::size_t index) const {
 }
 
 bitset::const_iterator bitset::begin() const {
-  return {_data, size_t(0)};
+  return {data(), size_t(0)};
 }
 
 bitset::iterator bitset::end() {
@@ -58,16 +113,43 @@ bitset::const_iterator bitset::end() const {
   return begin() + size();
 }
 
+bitset::const_view::run_range bitset::runs() const {
+  return const_view(*this).runs();
+}
+
+bitset::view::word_range bitset::words() {
+  return view(*this).words();
+}
+
+bitset::const_view::word_range bitset::words() const {
+  return const_view(*this).words();
+}
+
 bitset::bitset(const bitset& other)
-    : bitset(other.size()) {
-  std::uninitialized_copy_n(other._data, other.size_in_words(), _data);
+    : bitset(other, std::pmr::get_default_resource()) {}
+
+bitset::bitset(const bitset& other, std::pmr::memory_resource* resource)
+    : bitset(other.size(), resource) {
+  std::uninitialized_copy_n(other.data(), other.size_in_words(), data());
+}
+
+bitset::bitset(bitset&& other) noexcept
+    : _size(std::exchange(other._size, 0))
+    , _capacity(std::exchange(other._capacity, small_words))
+    , _storage(other._storage)
+    , _resource(other._resource) {}
+
+bitset& bitset::operator=(bitset&& other) & noexcept {
+  bitset tmp(std::move(other));
+  swap(tmp);
+  return *this;
 }
 
 bitset& bitset::operator=(const bitset& other) & {
   if (&other == this) {
     return *this;
   }
-  bitset tmp(other);
+  bitset tmp(other, _resource);
   swap(tmp);
   return *this;
 }
@@ -88,19 +170,19 @@ bitset::const_view bitset::subview(std::size_t offset, std::size_t count) const
   return const_view(*this).subview(offset, count);
 }
 
-bitset::bitset(std::string_view str)
-    : bitset(str.size()) {
+bitset::bitset(std::string_view str, std::pmr::memory_resource* resource)
+    : bitset(str.size(), resource) {
   for (size_t i = 0; i < size_in_words(); i++) {
-    new (_data + i) word_type(bts::stow(str.substr(bts::word_size * i, bts::word_size)));
+    new (data() + i) word_type(bts::stow(str.substr(bts::word_size * i, bts::word_size)));
   }
 }
 
-bitset::bitset(const bitset::const_view& other)
-    : bitset(other.size()) {
+bitset::bitset(const bitset::const_view& other, std::pmr::memory_resource* resource)
+    : bitset(other.size(), resource) {
   if (!other.empty()) {
     auto it = other.begin();
     for (size_t i = 0; i * bts::word_size < other.size(); it += bts::word_size, ++i) {
-      new (_data + i) word_type(it.get_word(std::min(other.size() - i * bts::word_size, bts::word_size)));
+      new (data() + i) word_type(it.get_word(std::min(other.size() - i * bts::word_size, bts::word_size)));
     }
   }
 }
@@ -109,7 +191,7 @@ bitset::bitset(bitset::const_iterator first, bitset::const_iterator last)
     : bitset::bitset(bitset::const_view(first, last)) {}
 
 bitset& bitset::operator=(std::string_view str) & {
-  bitset tmp(str);
+  bitset tmp(str, _resource);
   swap(tmp);
   return *this;
 }
@@ -118,7 +200,7 @@ bitset& bitset::operator=(const bitset::const_view& other) & {
   if (other.begin() == begin() && other.end() == end()) {
     return *this;
   }
-  bitset tmp(other);
+  bitset tmp(other, _resource);
   swap(tmp);
   return *this;
 }
@@ -139,21 +221,22 @@ bitset& bitset::operator^=(const bitset::const_view& other) & {
 }
 
 bitset& bitset::operator<<=(std::size_t count) & {
-  if (count == 0) {
-    return *this;
-  }
-  bitset tmp(size() + count, false);
-  std::copy_n(_data, size_in_words(), tmp._data);
-  swap(tmp);
+  resize(size() + count, false);
   return *this;
 }
 
 bitset& bitset::operator>>=(std::size_t count) & {
-  if (count >= size()) {
-    clear();
-    return *this;
-  }
-  *this = subview(0, size() - count);
+  resize(count >= size() ? 0 : size() - count);
+  return *this;
+}
+
+bitset& bitset::shift_left_inplace(std::size_t count) & {
+  view(*this).shift_left_inplace(count);
+  return *this;
+}
+
+bitset& bitset::shift_right_inplace(std::size_t count) & {
+  view(*this).shift_right_inplace(count);
   return *this;
 }
 
@@ -179,30 +262,50 @@ std::size_t bitset::count() const {
   return const_view(*this).count();
 }
 
-bitset::bitset()
-    : _size(0)
-    , _data(nullptr) {}
+std::size_t bitset::find_first() const {
+  return const_view(*this).find_first();
+}
 
-std::string bitset::to_string() const {
-  return const_view(*this).to_string();
+std::size_t bitset::find_next(std::size_t pos) const {
+  return const_view(*this).find_next(pos);
 }
 
-bitset operator&(const bitset::const_view& lhs, const bitset::const_view& rhs) {
-  bitset tmp(lhs);
-  tmp &= rhs;
-  return tmp;
+std::size_t bitset::find_last() const {
+  return const_view(*this).find_last();
 }
 
-bitset operator|(const bitset::const_view& lhs, const bitset::const_view& rhs) {
-  bitset tmp(lhs);
-  tmp |= rhs;
-  return tmp;
+std::size_t bitset::find_first_zero() const {
+  return const_view(*this).find_first_zero();
 }
 
-bitset operator^(const bitset::const_view& lhs, const bitset::const_view& rhs) {
-  bitset tmp(lhs);
-  tmp ^= rhs;
-  return tmp;
+void bitset::set_bits(std::span<const std::uint32_t> indices) & {
+  view(*this).set_bits(indices);
+}
+
+void bitset::reset_bits(std::span<const std::uint32_t> indices) & {
+  view(*this).reset_bits(indices);
+}
+
+void bitset::test_bits(std::span<const std::uint32_t> indices, std::span<bool> out) const {
+  const_view(*this).test_bits(indices, out);
+}
+
+bitset bitset::gather(std::span<const std::uint32_t> indices) const {
+  bitset res(indices.size(), false);
+  const_view(*this).gather(indices, res);
+  return res;
+}
+
+bitset::bitset()
+    : bitset(std::pmr::get_default_resource()) {}
+
+bitset::bitset(std::pmr::memory_resource* resource)
+    : _size(0)
+    , _capacity(small_words)
+    , _resource(resource) {}
+
+std::string bitset::to_string() const {
+  return const_view(*this).to_string();
 }
 
 void swap(bitset& lhs, bitset& rhs) noexcept {
@@ -218,10 +321,17 @@ std::ostream& operator<<(std::ostream& out, const bitset& bs) {
   return out;
 }
 
-bitset operator~(const bitset::const_view& bs) {
-  bitset tmp(bs);
-  tmp.flip();
-  return tmp;
+std::to_chars_result to_chars(char* first, char* last, const bitset& bs) {
+  return bitset::const_view(bs).to_chars(first, last);
+}
+
+std::from_chars_result from_chars(const char* first, const char* last, bitset& bs) {
+  const std::size_t digits = bts::binary_prefix({first, static_cast<std::size_t>(last - first)});
+  if (digits == 0) {
+    return {first, std::errc::invalid_argument};
+  }
+  bs.resize(digits);
+  return bitset::view(bs).from_chars(first, first + digits);
 }
 
 bool operator==(const bitset::const_view& lhs, const bitset::const_view& rhs) {
@@ -229,10 +339,31 @@ bool operator==(const bitset::const_view& lhs, const bitset::const_view& rhs) {
     return false;
   }
   bool res = true;
-  bitset::apply_operation<false>(lhs, rhs, [&res](bts::word_type a, bts::word_type b, size_t op_size) {
-    res &= bts::get_subword(a, 0, op_size) == bts::get_subword(b, 0, op_size);
+  auto compare = [&res](bts::word_type a, bts::word_type b, size_t op_size) {
+    res = bts::get_subword(a, 0, op_size) == bts::get_subword(b, 0, op_size);
     return res;
-  });
+  };
+
+  // Views starting at the same offset inside their words become word-aligned after the same number of bits,
+  // so only that head needs shifting.
+  std::size_t head = 0;
+  if (lhs.word_offset() == rhs.word_offset() && lhs.word_offset() != 0) {
+    head = std::min(lhs.size(), bts::word_size - lhs.word_offset());
+    bitset::apply_operation<false>(lhs.subview(0, head), rhs.subview(0, head), compare);
+    if (!res) {
+      return false;
+    }
+  }
+  bitset::const_view lhs_rest = lhs.subview(head);
+  bitset::const_view rhs_rest = rhs.subview(head);
+
+  std::size_t words = bitset::aligned_words(lhs_rest, rhs_rest);
+  if (!bitset::equal_words(lhs_rest, rhs_rest, words)) {
+    return false;
+  }
+  bitset::const_view lhs_tail = lhs_rest.subview(words * bts::word_size);
+  bitset::const_view rhs_tail = rhs_rest.subview(words * bts::word_size);
+  bitset::apply_operation<false>(lhs_tail, rhs_tail, compare);
   return res;
 }
 
@@ -240,12 +371,39 @@ bool operator!=(const bitset::const_view& lhs, const bitset::const_view& rhs) {
   return !(lhs == rhs);
 }
 
-bitset::bitset(size_t size)
+bitset::bitset(size_t size, std::pmr::memory_resource* resource)
     : _size(size)
-    , _data(size == 0 ? nullptr : static_cast<word_pointer>(operator new((size_in_words()) * sizeof(word_type)))) {}
+    , _capacity(std::max(size_in_words(), small_words))
+    , _resource(resource) {
+  if (!is_small()) {
+    _storage.dynamic_data = allocate(_capacity);
+  }
+}
+
+bool bitset::is_small() const {
+  return _capacity <= small_words;
+}
+
+bitset::word_pointer bitset::allocate(std::size_t words) const {
+  return static_cast<word_pointer>(_resource->allocate(words * sizeof(word_type), storage_alignment));
+}
+
+void bitset::deallocate() const {
+  if (!is_small()) {
+    _resource->deallocate(_storage.dynamic_data, _capacity * sizeof(word_type), storage_alignment);
+  }
+}
+
+bitset::word_pointer bitset::data() {
+  return is_small() ? _storage.static_data : _storage.dynamic_data;
+}
+
+const bitset::word_type* bitset::data() const {
+  return is_small() ? _storage.static_data : _storage.dynamic_data;
+}
 
 void bitset::clear() {
-  std::destroy_n(_data, size_in_words());
+  std::destroy_n(data(), size_in_words());
   _size = 0;
 }
 
@@ -258,10 +416,49 @@ void bitset::apply_operation(
   lhs.apply_operation<changeable>(rhs, word_operation);
 }
 
+std::size_t bitset::aligned_words(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  return lhs.aligned_words(rhs);
+}
+
+bool bitset::equal_words(const bitset::const_view& lhs, const bitset::const_view& rhs, std::size_t words) {
+  return bts::kernels::active().equal(lhs.begin()._current, rhs.begin()._current, words);
+}
+
+std::strong_ordering operator<=>(const bitset::const_view& lhs, const bitset::const_view& rhs) {
+  const std::size_t common = std::min(lhs.size(), rhs.size());
+  std::strong_ordering res = std::strong_ordering::equal;
+  bitset::apply_operation<false>(
+      lhs.subview(0, common),
+      rhs.subview(0, common),
+      [&res](bts::word_type a, bts::word_type b, size_t op_size) {
+        // The first bit is the most significant one, so words compare like the bits they hold.
+        res = bts::get_subword(a, 0, op_size) <=> bts::get_subword(b, 0, op_size);
+        return std::is_eq(res);
+      }
+  );
+  return std::is_neq(res) ? res : lhs.size() <=> rhs.size();
+}
+
 bool operator==(const bitset& left, const bitset& right) {
   return left.subview() == right.subview();
 }
 
+std::strong_ordering operator<=>(const bitset& left, const bitset& right) {
+  return left.subview() <=> right.subview();
+}
+
+std::size_t bts::hash(const bitset::const_view& bits) noexcept {
+  std::uint64_t res = bits.size() ^ 0x9e3779b97f4a7c15;
+  bitset_view_expression(bits).for_each_word([&res](std::size_t, bts::word_type word, std::size_t) {
+    res = std::rotl((res ^ word) * 0xbf58476d1ce4e5b9, 27);
+    return true;
+  });
+  // Final avalanche from splitmix64.
+  res = (res ^ (res >> 30)) * 0xbf58476d1ce4e5b9;
+  res = (res ^ (res >> 27)) * 0x94d049bb133111eb;
+  return static_cast<std::size_t>(res ^ (res >> 31));
+}
+
 bool operator!=(const bitset& left, const bitset& right) {
   return !(left == right);
 }
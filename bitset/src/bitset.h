@@ -1,21 +1,31 @@
 #pragma once
 
+#include "bitset-expression.h"
 #include "bitset-iterator.h"
+#include "bitset-kernels.h"
 #include "bitset-reference.h"
 #include "bitset-view.h"
 #include "bts.h"
 
 #include <algorithm>
 #include <bit>
+#include <charconv>
+#include <compare>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <memory_resource>
 #include <ranges>
+#include <span>
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <utility>
 
+// Words that do not fit inline come from a `std::pmr::memory_resource`, the default one unless another is
+// given on construction, and are aligned to `storage_alignment` bytes. Copies and reassignments keep the
+// resource of the bitset being constructed or assigned to, moves carry the resource along with the words.
 class bitset {
 public:
   using word_type = bts::word_type;
@@ -30,26 +40,54 @@ public:
 
 public:
   static constexpr std::size_t npos = -1;
+  // Alignment of allocated words, a cache line so that vectorized kernels never split one.
+  static constexpr std::size_t storage_alignment = 64;
 
   bitset();
+  explicit bitset(std::pmr::memory_resource* resource);
 
-  bitset(std::size_t size, bool value);
+  bitset(std::size_t size, bool value, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+  // `size` bits with exactly the bits of `runs` set.
+  bitset(
+      std::size_t size,
+      std::span<const bitset_run> runs,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+  );
   bitset(const bitset& other);
-  explicit bitset(std::string_view str);
-  explicit bitset(const const_view& other);
+  bitset(const bitset& other, std::pmr::memory_resource* resource);
+  bitset(bitset&& other) noexcept;
+  explicit bitset(std::string_view str, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+  explicit bitset(const const_view& other, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
   bitset(const_iterator first, const_iterator last);
 
+  template <bitset_expression E>
+  bitset(const E& expression, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
   bitset& operator=(const bitset& other) &;
+  bitset& operator=(bitset&& other) & noexcept;
   bitset& operator=(std::string_view str) &;
   bitset& operator=(const const_view& other) &;
 
+  template <bitset_expression E>
+  bitset& operator=(const E& expression) &;
+
   ~bitset();
 
   void swap(bitset& other) noexcept;
 
+  std::pmr::memory_resource* get_memory_resource() const;
+
   std::size_t size() const;
   bool empty() const;
 
+  // Number of bits the bitset can hold before it has to reallocate.
+  std::size_t capacity() const;
+  void reserve(std::size_t size);
+
+  // Appending grows the storage geometrically, so a sequence of appends takes amortized O(1) per bit.
+  void resize(std::size_t size, bool value = false);
+  void push_back(bool value);
+
   reference operator[](std::size_t index);
   const_reference operator[](std::size_t index) const;
 
@@ -59,11 +97,24 @@ public:
   iterator end();
   const_iterator end() const;
 
+  view::word_range words();
+  const_view::word_range words() const;
+
   bitset& operator&=(const const_view& other) &;
   bitset& operator|=(const const_view& other) &;
   bitset& operator^=(const const_view& other) &;
+
+  template <bitset_expression E>
+  bitset& operator&=(const E& expression) &;
+  template <bitset_expression E>
+  bitset& operator|=(const E& expression) &;
+  template <bitset_expression E>
+  bitset& operator^=(const E& expression) &;
+
   bitset& operator<<=(std::size_t count) &;
   bitset& operator>>=(std::size_t count) &;
+  bitset& shift_left_inplace(std::size_t count) &;
+  bitset& shift_right_inplace(std::size_t count) &;
   void flip() &;
 
   bitset& set() &;
@@ -73,6 +124,24 @@ public:
   bool any() const;
   std::size_t count() const;
 
+  std::size_t find_first() const;
+  std::size_t find_next(std::size_t pos) const;
+  std::size_t find_last() const;
+  std::size_t find_first_zero() const;
+
+  template <typename visitor_type>
+  void for_each_set(visitor_type visitor) const;
+
+  template <typename visitor_type>
+  void for_each_run(visitor_type visitor) const;
+  const_view::run_range runs() const;
+
+  void set_bits(std::span<const std::uint32_t> indices) &;
+  void reset_bits(std::span<const std::uint32_t> indices) &;
+  void test_bits(std::span<const std::uint32_t> indices, std::span<bool> out) const;
+  // Bit `i` of the result is `(*this)[indices[i]]`.
+  bitset gather(std::span<const std::uint32_t> indices) const;
+
   operator const_view() const;
   operator view();
 
@@ -85,32 +154,166 @@ public:
 
   friend bool operator==(const bitset::const_view& lhs, const bitset::const_view& rhs);
   friend bool operator!=(const bitset::const_view& lhs, const bitset::const_view& rhs);
+  friend std::strong_ordering operator<=>(const bitset::const_view& lhs, const bitset::const_view& rhs);
 
 private:
-  explicit bitset(size_t);
+  explicit bitset(size_t, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
   size_t size_in_words() const;
+  static size_t words_for(std::size_t size);
+
+  bool is_small() const;
+  word_pointer allocate(std::size_t words) const;
+  void deallocate() const;
+  word_pointer data();
+  const word_type* data() const;
 
   template <bool changeable = true, typename word_operation_type>
   static void apply_operation(const const_view& lhs, const const_view& rhs, word_operation_type word_operation);
 
+  static std::size_t aligned_words(const const_view& lhs, const const_view& rhs);
+  static bool equal_words(const const_view& lhs, const const_view& rhs, std::size_t words);
+
 private:
+  // Bitsets of up to `small_words` words keep them inline instead of allocating, much like `socow_vector`.
+  static constexpr std::size_t small_words = 2;
+
+  union storage {
+    word_type static_data[small_words];
+    word_pointer dynamic_data;
+  };
+
   size_t _size;
-  word_pointer _data;
+  size_t _capacity;
+  storage _storage{};
+  std::pmr::memory_resource* _resource;
 };
 
-bitset operator&(const bitset::const_view& lhs, const bitset::const_view& rhs);
-bitset operator|(const bitset::const_view& lhs, const bitset::const_view& rhs);
-bitset operator^(const bitset::const_view& lhs, const bitset::const_view& rhs);
-bitset operator~(const bitset::const_view& bs);
+template <typename visitor_type>
+void bitset::for_each_set(visitor_type visitor) const {
+  const_view(*this).for_each_set(visitor);
+}
+
+template <typename visitor_type>
+void bitset::for_each_run(visitor_type visitor) const {
+  const_view(*this).for_each_run(visitor);
+}
+
+template <bitset_expression E>
+bitset::bitset(const E& expression, std::pmr::memory_resource* resource)
+    : bitset(expression.size(), resource) {
+  word_pointer data = this->data();
+  expression.for_each_word([data](std::size_t index, word_type word, std::size_t) {
+    new (data + index) word_type(word);
+    return true;
+  });
+}
+
+template <bitset_expression E>
+bitset& bitset::operator=(const E& expression) & {
+  if (size() != expression.size()) {
+    bitset tmp(expression, _resource);
+    swap(tmp);
+    return *this;
+  }
+  // Any view into this bitset starts at or after `data()`, so computing word `i` only reads words
+  // that have not been overwritten yet and the result can be stored in place.
+  word_pointer data = this->data();
+  expression.for_each_word([data](std::size_t index, word_type word, std::size_t) {
+    data[index] = word;
+    return true;
+  });
+  return *this;
+}
+
+template <bitset_expression E>
+bitset& bitset::operator&=(const E& expression) & {
+  word_pointer data = this->data();
+  expression.for_each_word([data](std::size_t index, word_type word, std::size_t op_size) {
+    bts::set_subword(data[index], data[index] & word, 0, op_size);
+    return true;
+  });
+  return *this;
+}
+
+template <bitset_expression E>
+bitset& bitset::operator|=(const E& expression) & {
+  word_pointer data = this->data();
+  expression.for_each_word([data](std::size_t index, word_type word, std::size_t op_size) {
+    bts::set_subword(data[index], data[index] | word, 0, op_size);
+    return true;
+  });
+  return *this;
+}
+
+template <bitset_expression E>
+bitset& bitset::operator^=(const E& expression) & {
+  word_pointer data = this->data();
+  expression.for_each_word([data](std::size_t index, word_type word, std::size_t op_size) {
+    bts::set_subword(data[index], data[index] ^ word, 0, op_size);
+    return true;
+  });
+  return *this;
+}
+
 bitset operator<<(const bitset::const_view& bs, std::size_t count);
 bitset operator>>(const bitset::const_view& bs, std::size_t count);
 
+template <bitset_expression E>
+bitset operator<<(const E& expression, std::size_t count) {
+  bitset tmp(expression);
+  tmp <<= count;
+  return tmp;
+}
+
+template <bitset_expression E>
+bitset operator>>(const E& expression, std::size_t count) {
+  bitset tmp(expression);
+  tmp >>= count;
+  return tmp;
+}
+
 bool operator==(const bitset::const_view& lhs, const bitset::const_view& rhs);
 bool operator!=(const bitset::const_view& lhs, const bitset::const_view& rhs);
 
 bool operator==(const bitset& left, const bitset& right);
 bool operator!=(const bitset& left, const bitset& right);
 
+// Lexicographic order of the bits, a proper prefix is less than the whole.
+std::strong_ordering operator<=>(const bitset::const_view& lhs, const bitset::const_view& rhs);
+std::strong_ordering operator<=>(const bitset& left, const bitset& right);
+
+namespace bts {
+
+// Depends only on the bits, not on where a view starts inside its words.
+std::size_t hash(const bitset::const_view& bits) noexcept;
+
+} // namespace bts
+
+// Both hashes are transparent, so containers keyed by `bitset` can be searched with views.
+template <>
+struct std::hash<bitset> {
+  using is_transparent = void;
+
+  std::size_t operator()(const bitset::const_view& bits) const noexcept {
+    return bts::hash(bits);
+  }
+};
+
+template <typename T>
+struct std::hash<bitset_view<T>> {
+  using is_transparent = void;
+
+  std::size_t operator()(const bitset::const_view& bits) const noexcept {
+    return bts::hash(bits);
+  }
+};
+
 void swap(bitset& lhs, bitset& rhs) noexcept;
 std::string to_string(const bitset& bs);
 std::ostream& operator<<(std::ostream& out, const bitset& bs);
+
+std::to_chars_result to_chars(char* first, char* last, const bitset& bs);
+
+// Replaces `bs` with the longest prefix of [first, last) made of '0' and '1' characters, reusing its storage.
+// Fails with `invalid_argument` and leaves `bs` unchanged if there is no such prefix.
+std::from_chars_result from_chars(const char* first, const char* last, bitset& bs);
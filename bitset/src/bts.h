@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <string_view>
 
 namespace bts {
 using word_type = uint64_t;
@@ -9,23 +12,106 @@ constexpr size_t word_size = sizeof(word_type) * 8;
 constexpr word_type word_ones = ~word_type(0);
 constexpr word_type word_zeros = word_type(0);
 
-inline word_type get_subword(word_type w, size_t index, size_t size) {
+constexpr word_type get_subword(word_type w, size_t index, size_t size) {
   return w & ((word_ones << (word_size - size)) >> index);
 }
 
-inline void set_subword(word_type& lhs, word_type rhs, size_t index, size_t size) {
+constexpr void set_subword(word_type& lhs, word_type rhs, size_t index, size_t size) {
   word_type mask = get_subword(word_ones, index, size);
   lhs = (lhs & (~mask)) | (rhs & mask);
 }
 
-inline word_type stow(std::basic_string_view<char> src) {
+// Hints that the cache line holding `address` is about to be read (`rw` is 0) or written (`rw` is 1).
+// A write hint takes the line exclusive, so readers should not use it. No-op where the builtin is missing.
+template <int rw>
+inline void prefetch(const void* address) {
+  static_assert(rw == 0 || rw == 1);
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address, rw);
+#else
+  static_cast<void>(address);
+#endif
+}
+
+namespace detail {
+
+constexpr word_type byte_ones = 0x0101010101010101;
+constexpr word_type byte_high_bits = 0x8080808080808080;
+
+// Loads 8 characters so that `src[i]` is byte `i` counting from the least significant one.
+constexpr word_type load_chars(const char* src) {
+  word_type res = 0;
+  for (size_t i = 0; i < 8; i++) {
+    res |= word_type(static_cast<unsigned char>(src[i])) << (8 * i);
+  }
+  return res;
+}
+
+constexpr void store_chars(char* dst, word_type chars) {
+  for (size_t i = 0; i < 8; i++) {
+    dst[i] = static_cast<char>(chars >> (8 * i));
+  }
+}
+
+// Packs 8 loaded characters into a byte, first character in the most significant bit.
+constexpr word_type pack_chars(word_type chars) {
+  // Bytes equal to '1' become zero, then exactly those bytes get their high bit set.
+  word_type diff = chars ^ (byte_ones * '1');
+  word_type ones = ~(((diff & ~byte_high_bits) + ~byte_high_bits) | diff) & byte_high_bits;
+  // Moves the flag of byte `i` to bit `7 - i` of the top byte.
+  return ((ones >> 7) * 0x8040201008040201) >> 56;
+}
+
+// Inverse of `pack_chars`: spreads the bits of `byte` into 8 characters.
+constexpr word_type unpack_chars(word_type byte) {
+  word_type bits = (byte * byte_ones) & 0x0102040810204080;
+  return (((bits + ~byte_high_bits) >> 7) & byte_ones) | (byte_ones * '0');
+}
+
+} // namespace detail
+
+// Parses up to `word_size` characters into a word, first character in the most significant bit.
+// Every character other than '1' is read as zero.
+constexpr word_type stow(std::basic_string_view<char> src) {
   word_type res = 0;
   size_t len = std::min(word_size, src.size());
-  for (size_t i = 0; i < len; i++) {
+  size_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    res = (res << 8) | detail::pack_chars(detail::load_chars(src.data() + i));
+  }
+  for (; i < len; i++) {
     res = (res << 1) | word_type(src[i] == '1' ? 1 : 0);
   }
-  res <<= word_size - len;
+  if (len != 0) {
+    res <<= word_size - len;
+  }
   return res;
 }
 
+// Writes the `size` most significant bits of `w` to `dst` as '0' and '1' characters.
+constexpr void wtos(word_type w, size_t size, char* dst) {
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    detail::store_chars(dst + i, detail::unpack_chars((w >> (word_size - 8 - i)) & 0xff));
+  }
+  for (; i < size; i++) {
+    dst[i] = ((w >> (word_size - 1 - i)) & 1) != 0 ? '1' : '0';
+  }
+}
+
+// Returns the length of the longest prefix of `src` made of '0' and '1' characters.
+constexpr size_t binary_prefix(std::basic_string_view<char> src) {
+  size_t i = 0;
+  for (; i + 8 <= src.size(); i += 8) {
+    // Binary digits differ from '0' only in the lowest bit.
+    if (((detail::load_chars(src.data() + i) ^ (detail::byte_ones * '0')) & ~detail::byte_ones) != 0) {
+      break;
+    }
+  }
+  while (i < src.size() && (src[i] == '0' || src[i] == '1')) {
+    i++;
+  }
+  return i;
+}
+
 } // namespace bts
@@ -0,0 +1,561 @@
+#include "compressed-bitset.h"
+
+#include "bitset-kernels.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+namespace bts::roaring {
+
+namespace {
+
+using bitmap_words = std::array<word_type, chunk_words>;
+
+constexpr std::size_t bitmap_bytes = chunk_words * sizeof(word_type);
+
+word_type bit_mask(std::uint16_t value) {
+  return word_type(1) << (word_size - 1 - value % word_size);
+}
+
+bitset::const_view bitmap_view(const word_type* words) {
+  return {words, chunk_bits};
+}
+
+std::size_t count_runs(const word_type* words) {
+  std::size_t res = 0;
+  word_type previous = word_zeros;
+  for (std::size_t i = 0; i < chunk_words; ++i) {
+    // A run starts at every set bit whose predecessor, one position more significant, is clear.
+    res += std::popcount(words[i] & ~((words[i] >> 1) | (previous << (word_size - 1))));
+    previous = words[i];
+  }
+  return res;
+}
+
+array_container make_array(const word_type* words, std::size_t cardinality) {
+  array_container res;
+  res.values.reserve(cardinality);
+  bitmap_view(words).for_each_set([&res](std::size_t pos) { res.values.push_back(static_cast<std::uint16_t>(pos)); });
+  return res;
+}
+
+run_container make_runs(const word_type* words, std::size_t runs) {
+  run_container res;
+  res.runs.reserve(runs);
+  const bitset::const_view bits = bitmap_view(words);
+  for (std::size_t first = bits.find_first(); first != bitset::npos;) {
+    std::size_t length = bits.subview(first).find_first_zero();
+    std::size_t last = length == bitset::npos ? chunk_bits - 1 : first + length - 1;
+    res.runs.push_back({static_cast<std::uint16_t>(first), static_cast<std::uint16_t>(last)});
+    first = last + 1 == chunk_bits ? bitset::npos : bits.find_next(last);
+  }
+  return res;
+}
+
+container make_bitmap(const word_type* words, std::size_t cardinality) {
+  return bitmap_container{std::vector<word_type>(words, words + chunk_words), cardinality};
+}
+
+std::optional<container> make_sorted_container(std::vector<std::uint16_t> values) {
+  if (values.empty()) {
+    return std::nullopt;
+  }
+  if (values.size() <= array_limit) {
+    return array_container{std::move(values)};
+  }
+  bitmap_words words{};
+  for (std::uint16_t value : values) {
+    words[value / word_size] |= bit_mask(value);
+  }
+  return make_container(words.data());
+}
+
+} // namespace
+
+std::size_t cardinality(const container& c) {
+  if (const auto* array = std::get_if<array_container>(&c)) {
+    return array->values.size();
+  }
+  if (const auto* bitmap = std::get_if<bitmap_container>(&c)) {
+    return bitmap->cardinality;
+  }
+  std::size_t res = 0;
+  for (auto [first, last] : std::get<run_container>(c).runs) {
+    res += last - first + 1;
+  }
+  return res;
+}
+
+bool contains(const container& c, std::uint16_t value) {
+  if (const auto* array = std::get_if<array_container>(&c)) {
+    return std::binary_search(array->values.begin(), array->values.end(), value);
+  }
+  if (const auto* bitmap = std::get_if<bitmap_container>(&c)) {
+    return (bitmap->words[value / word_size] & bit_mask(value)) != 0;
+  }
+  const auto& runs = std::get<run_container>(c).runs;
+  auto it = std::upper_bound(runs.begin(), runs.end(), value, [](std::uint16_t v, const run_container::run& run) {
+    return v < run.first;
+  });
+  return it != runs.begin() && value <= std::prev(it)->last;
+}
+
+bool update(container& c, std::uint16_t value, bool state) {
+  if (auto* array = std::get_if<array_container>(&c)) {
+    auto& values = array->values;
+    auto it = std::lower_bound(values.begin(), values.end(), value);
+    bool present = it != values.end() && *it == value;
+    if (state && !present) {
+      if (values.size() == array_limit) {
+        bitmap_words words{};
+        fill_words(c, words.data());
+        words[value / word_size] |= bit_mask(value);
+        c = make_bitmap(words.data(), array_limit + 1);
+      } else {
+        values.insert(it, value);
+      }
+    } else if (!state && present) {
+      values.erase(it);
+      return !values.empty();
+    }
+    return true;
+  }
+  if (auto* bitmap = std::get_if<bitmap_container>(&c)) {
+    word_type& word = bitmap->words[value / word_size];
+    if (((word & bit_mask(value)) != 0) == state) {
+      return true;
+    }
+    word ^= bit_mask(value);
+    bitmap->cardinality = state ? bitmap->cardinality + 1 : bitmap->cardinality - 1;
+    if (bitmap->cardinality <= array_limit) {
+      c = make_array(bitmap->words.data(), bitmap->cardinality);
+    }
+    return cardinality(c) != 0;
+  }
+  auto& runs = std::get<run_container>(c).runs;
+  auto next = std::upper_bound(runs.begin(), runs.end(), value, [](std::uint16_t v, const run_container::run& run) {
+    return v < run.first;
+  });
+  const bool present = next != runs.begin() && value <= std::prev(next)->last;
+  if (state == present) {
+    return true;
+  }
+  if (!state) {
+    auto run = std::prev(next);
+    if (run->first == run->last) {
+      runs.erase(run);
+      return !runs.empty();
+    }
+    if (value == run->first) {
+      ++run->first;
+    } else if (value == run->last) {
+      --run->last;
+    } else {
+      const std::uint16_t last = run->last;
+      run->last = value - 1;
+      runs.insert(next, {static_cast<std::uint16_t>(value + 1), last});
+    }
+  } else {
+    const bool joins_prev = next != runs.begin() && std::prev(next)->last + 1 == value;
+    const bool joins_next = next != runs.end() && next->first == value + 1;
+    if (joins_prev && joins_next) {
+      std::prev(next)->last = next->last;
+      runs.erase(next);
+    } else if (joins_prev) {
+      std::prev(next)->last = value;
+    } else if (joins_next) {
+      next->first = value;
+    } else {
+      runs.insert(next, {value, value});
+    }
+  }
+  if (runs.size() * sizeof(run_container::run) > bitmap_bytes) {
+    // Too fragmented to be worth keeping as runs.
+    bitmap_words words;
+    fill_words(c, words.data());
+    c = *make_container(words.data());
+  }
+  return true;
+}
+
+std::optional<container> make_container(const word_type* words) {
+  const std::size_t cardinality = kernels::active().popcount(words, chunk_words);
+  if (cardinality == 0) {
+    return std::nullopt;
+  }
+  const std::size_t runs = count_runs(words);
+  const std::size_t array_bytes =
+      cardinality <= array_limit ? cardinality * sizeof(std::uint16_t) : std::numeric_limits<std::size_t>::max();
+  const std::size_t run_bytes = runs * sizeof(run_container::run);
+
+  if (array_bytes <= run_bytes && array_bytes <= bitmap_bytes) {
+    return make_array(words, cardinality);
+  }
+  if (run_bytes <= bitmap_bytes) {
+    return make_runs(words, runs);
+  }
+  return make_bitmap(words, cardinality);
+}
+
+void fill_words(const container& c, word_type* words) {
+  if (const auto* bitmap = std::get_if<bitmap_container>(&c)) {
+    std::copy(bitmap->words.begin(), bitmap->words.end(), words);
+    return;
+  }
+  std::fill(words, words + chunk_words, word_zeros);
+  if (const auto* array = std::get_if<array_container>(&c)) {
+    for (std::uint16_t value : array->values) {
+      words[value / word_size] |= bit_mask(value);
+    }
+    return;
+  }
+  const bitset::view bits(words, chunk_bits);
+  for (auto [first, last] : std::get<run_container>(c).runs) {
+    bits.subview(first, last - first + 1).set();
+  }
+}
+
+std::optional<container> combine(const container& lhs, const container& rhs, operation op) {
+  const auto* lhs_array = std::get_if<array_container>(&lhs);
+  const auto* rhs_array = std::get_if<array_container>(&rhs);
+
+  if (lhs_array && rhs_array) {
+    const auto& a = lhs_array->values;
+    const auto& b = rhs_array->values;
+    std::vector<std::uint16_t> res;
+    switch (op) {
+    case operation::AND:
+      std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(res));
+      break;
+    case operation::OR:
+      std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(res));
+      break;
+    case operation::XOR:
+      std::set_symmetric_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(res));
+      break;
+    }
+    return make_sorted_container(std::move(res));
+  }
+
+  if (op == operation::AND && (lhs_array || rhs_array)) {
+    const auto& values = lhs_array ? lhs_array->values : rhs_array->values;
+    const container& other = lhs_array ? rhs : lhs;
+    std::vector<std::uint16_t> res;
+    std::copy_if(values.begin(), values.end(), std::back_inserter(res), [&other](std::uint16_t value) {
+      return contains(other, value);
+    });
+    return make_sorted_container(std::move(res));
+  }
+
+  bitmap_words lhs_words;
+  bitmap_words rhs_words;
+  fill_words(lhs, lhs_words.data());
+  fill_words(rhs, rhs_words.data());
+  const kernels::kernel_set& kernels = kernels::active();
+  switch (op) {
+  case operation::AND:
+    kernels.and_words(lhs_words.data(), rhs_words.data(), chunk_words);
+    break;
+  case operation::OR:
+    kernels.or_words(lhs_words.data(), rhs_words.data(), chunk_words);
+    break;
+  case operation::XOR:
+    kernels.xor_words(lhs_words.data(), rhs_words.data(), chunk_words);
+    break;
+  }
+  return make_container(lhs_words.data());
+}
+
+bool equal(const container& lhs, const container& rhs) {
+  if (cardinality(lhs) != cardinality(rhs)) {
+    return false;
+  }
+  const auto* lhs_array = std::get_if<array_container>(&lhs);
+  const auto* rhs_array = std::get_if<array_container>(&rhs);
+  if (lhs_array && rhs_array) {
+    return lhs_array->values == rhs_array->values;
+  }
+  bitmap_words lhs_words;
+  bitmap_words rhs_words;
+  fill_words(lhs, lhs_words.data());
+  fill_words(rhs, rhs_words.data());
+  return lhs_words == rhs_words;
+}
+
+std::size_t memory_usage(const container& c) {
+  if (const auto* array = std::get_if<array_container>(&c)) {
+    return array->values.capacity() * sizeof(std::uint16_t);
+  }
+  if (const auto* bitmap = std::get_if<bitmap_container>(&c)) {
+    return bitmap->words.capacity() * sizeof(word_type);
+  }
+  return std::get<run_container>(c).runs.capacity() * sizeof(run_container::run);
+}
+
+void first(const container& c, std::size_t& slot, std::uint16_t& value) {
+  slot = 0;
+  if (const auto* array = std::get_if<array_container>(&c)) {
+    value = array->values.front();
+  } else if (const auto* bitmap = std::get_if<bitmap_container>(&c)) {
+    value = static_cast<std::uint16_t>(bitmap_view(bitmap->words.data()).find_first());
+  } else {
+    value = std::get<run_container>(c).runs.front().first;
+  }
+}
+
+bool next(const container& c, std::size_t& slot, std::uint16_t& value) {
+  if (const auto* array = std::get_if<array_container>(&c)) {
+    if (++slot == array->values.size()) {
+      return false;
+    }
+    value = array->values[slot];
+    return true;
+  }
+  if (const auto* bitmap = std::get_if<bitmap_container>(&c)) {
+    std::size_t pos = bitmap_view(bitmap->words.data()).find_next(value);
+    if (pos == bitset::npos) {
+      return false;
+    }
+    value = static_cast<std::uint16_t>(pos);
+    return true;
+  }
+  const auto& runs = std::get<run_container>(c).runs;
+  if (value < runs[slot].last) {
+    ++value;
+    return true;
+  }
+  if (++slot == runs.size()) {
+    return false;
+  }
+  value = runs[slot].first;
+  return true;
+}
+
+} // namespace bts::roaring
+
+namespace {
+
+std::vector<bts::roaring::chunk>::const_iterator find_chunk(
+    const std::vector<bts::roaring::chunk>& chunks,
+    std::size_t key
+) {
+  return std::lower_bound(chunks.begin(), chunks.end(), key, [](const bts::roaring::chunk& c, std::size_t k) {
+    return c.key < k;
+  });
+}
+
+} // namespace
+
+compressed_bitset::compressed_bitset(std::size_t size)
+    : _size(size) {}
+
+compressed_bitset::compressed_bitset(const bitset::const_view& bits)
+    : _size(bits.size()) {
+  std::array<bts::word_type, bts::roaring::chunk_words> words;
+  for (std::size_t pos = 0; pos < _size; pos += bts::roaring::chunk_bits) {
+    const std::size_t count = std::min(_size - pos, bts::roaring::chunk_bits);
+    const bitset::const_view chunk_bits = bits.subview(pos, count);
+    if (!chunk_bits.any()) {
+      continue;
+    }
+    words.fill(bts::word_zeros);
+    bitset::view(words.data(), count) |= chunk_bits;
+    _chunks.push_back({pos / bts::roaring::chunk_bits, *bts::roaring::make_container(words.data())});
+  }
+}
+
+std::size_t compressed_bitset::size() const {
+  return _size;
+}
+
+bool compressed_bitset::empty() const {
+  return _size == 0;
+}
+
+bool compressed_bitset::test(std::size_t index) const {
+  assert(index < _size);
+  const std::size_t key = index / bts::roaring::chunk_bits;
+  auto it = find_chunk(_chunks, key);
+  return it != _chunks.end() && it->key == key &&
+         bts::roaring::contains(it->bits, static_cast<std::uint16_t>(index % bts::roaring::chunk_bits));
+}
+
+bool compressed_bitset::operator[](std::size_t index) const {
+  return test(index);
+}
+
+compressed_bitset& compressed_bitset::set(std::size_t index, bool value) {
+  assert(index < _size);
+  const std::size_t key = index / bts::roaring::chunk_bits;
+  const auto low = static_cast<std::uint16_t>(index % bts::roaring::chunk_bits);
+  auto it = _chunks.begin() + (find_chunk(_chunks, key) - _chunks.cbegin());
+  if (it == _chunks.end() || it->key != key) {
+    if (value) {
+      // Built in place: moving a temporary variant in trips a false -Wmaybe-uninitialized in GCC.
+      auto added = _chunks.emplace(it);
+      added->key = key;
+      std::get<bts::roaring::array_container>(added->bits).values.push_back(low);
+    }
+  } else if (!bts::roaring::update(it->bits, low, value)) {
+    _chunks.erase(it);
+  }
+  return *this;
+}
+
+compressed_bitset& compressed_bitset::reset(std::size_t index) {
+  return set(index, false);
+}
+
+std::size_t compressed_bitset::count() const {
+  std::size_t res = 0;
+  for (const auto& chunk : _chunks) {
+    res += bts::roaring::cardinality(chunk.bits);
+  }
+  return res;
+}
+
+bool compressed_bitset::all() const {
+  return count() == _size;
+}
+
+bool compressed_bitset::any() const {
+  return !_chunks.empty();
+}
+
+void compressed_bitset::combine(const compressed_bitset& other, bts::roaring::operation op) {
+  std::vector<bts::roaring::chunk> res;
+  auto lhs = _chunks.begin();
+  auto rhs = other._chunks.begin();
+  while (lhs != _chunks.end() || rhs != other._chunks.end()) {
+    if (rhs == other._chunks.end() || (lhs != _chunks.end() && lhs->key < rhs->key)) {
+      // Chunks present on one side only are kept as they are by `|` and `^`, and dropped by `&`.
+      if (op != bts::roaring::operation::AND) {
+        res.push_back(std::move(*lhs));
+      }
+      ++lhs;
+    } else if (lhs == _chunks.end() || rhs->key < lhs->key) {
+      if (op != bts::roaring::operation::AND) {
+        res.push_back(*rhs);
+      }
+      ++rhs;
+    } else {
+      if (auto bits = bts::roaring::combine(lhs->bits, rhs->bits, op)) {
+        res.push_back({lhs->key, std::move(*bits)});
+      }
+      ++lhs;
+      ++rhs;
+    }
+  }
+  _chunks = std::move(res);
+}
+
+compressed_bitset& compressed_bitset::operator&=(const compressed_bitset& other) & {
+  combine(other, bts::roaring::operation::AND);
+  return *this;
+}
+
+compressed_bitset& compressed_bitset::operator|=(const compressed_bitset& other) & {
+  combine(other, bts::roaring::operation::OR);
+  return *this;
+}
+
+compressed_bitset& compressed_bitset::operator^=(const compressed_bitset& other) & {
+  combine(other, bts::roaring::operation::XOR);
+  return *this;
+}
+
+compressed_bitset::const_iterator compressed_bitset::begin() const {
+  return {&_chunks, 0};
+}
+
+compressed_bitset::const_iterator compressed_bitset::end() const {
+  return {&_chunks, _chunks.size()};
+}
+
+bitset compressed_bitset::to_bitset(std::size_t offset, std::size_t count) const {
+  if (offset >= _size) {
+    return {};
+  }
+  count = std::min(count, _size - offset);
+  bitset res(count, false);
+  const std::size_t end = offset + count;
+
+  for (auto it = find_chunk(_chunks, offset / bts::roaring::chunk_bits); it != _chunks.end(); ++it) {
+    const std::size_t base = it->key * bts::roaring::chunk_bits;
+    if (base >= end) {
+      break;
+    }
+    // Part of the chunk inside the requested range, relative to the chunk.
+    const std::size_t first = std::max(offset, base) - base;
+    const std::size_t last = std::min(end, base + bts::roaring::chunk_bits) - base;
+    // Positions in the chunk map to `base + position - offset` in the result, never negative as `first` is at
+    // least `offset - base`.
+
+    if (const auto* bitmap = std::get_if<bts::roaring::bitmap_container>(&it->bits)) {
+      res.subview(base + first - offset, last - first) |=
+          bitset::const_view(bitmap->words.data(), bts::roaring::chunk_bits).subview(first, last - first);
+    } else if (const auto* array = std::get_if<bts::roaring::array_container>(&it->bits)) {
+      auto value = std::lower_bound(array->values.begin(), array->values.end(), first);
+      for (; value != array->values.end() && *value < last; ++value) {
+        res[base + *value - offset] = true;
+      }
+    } else {
+      for (auto [run_first, run_last] : std::get<bts::roaring::run_container>(it->bits).runs) {
+        const std::size_t from = std::max<std::size_t>(run_first, first);
+        const std::size_t to = std::min<std::size_t>(run_last + 1, last);
+        if (from < to) {
+          res.subview(base + from - offset, to - from).set();
+        }
+      }
+    }
+  }
+  return res;
+}
+
+std::size_t compressed_bitset::memory_usage() const {
+  std::size_t res = _chunks.capacity() * sizeof(bts::roaring::chunk);
+  for (const auto& chunk : _chunks) {
+    res += bts::roaring::memory_usage(chunk.bits);
+  }
+  return res;
+}
+
+compressed_bitset operator&(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  compressed_bitset res = lhs;
+  res &= rhs;
+  return res;
+}
+
+compressed_bitset operator|(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  compressed_bitset res = lhs;
+  res |= rhs;
+  return res;
+}
+
+compressed_bitset operator^(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  compressed_bitset res = lhs;
+  res ^= rhs;
+  return res;
+}
+
+bool operator==(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  return lhs._size == rhs._size &&
+         std::equal(
+             lhs._chunks.begin(),
+             lhs._chunks.end(),
+             rhs._chunks.begin(),
+             rhs._chunks.end(),
+             [](const bts::roaring::chunk& a, const bts::roaring::chunk& b) {
+               return a.key == b.key && bts::roaring::equal(a.bits, b.bits);
+             }
+         );
+}
+
+bool operator!=(const compressed_bitset& lhs, const compressed_bitset& rhs) {
+  return !(lhs == rhs);
+}
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "bitset.h"
+#include "bts.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <variant>
+#include <vector>
+
+// Containers of a `compressed_bitset`. Each one holds the set bits of a chunk of 2^16 consecutive
+// positions as their low 16 bits, and is never empty.
+namespace bts::roaring {
+
+constexpr std::size_t chunk_bits = std::size_t(1) << 16;
+constexpr std::size_t chunk_words = chunk_bits / word_size;
+
+// Arrays with more values than this take more memory than a bitmap.
+constexpr std::size_t array_limit = 4096;
+
+// Sorted positions of the set bits.
+struct array_container {
+  std::vector<std::uint16_t> values;
+};
+
+// All bits of the chunk, laid out the way `bitset` stores them.
+struct bitmap_container {
+  std::vector<word_type> words;
+  std::size_t cardinality = 0;
+};
+
+// Sorted, non-adjacent ranges of set bits.
+struct run_container {
+  struct run {
+    std::uint16_t first;
+    std::uint16_t last;
+  };
+
+  std::vector<run> runs;
+};
+
+using container = std::variant<array_container, bitmap_container, run_container>;
+
+struct chunk {
+  std::size_t key;
+  container bits;
+};
+
+enum class operation {
+  AND,
+  OR,
+  XOR,
+};
+
+std::size_t cardinality(const container& c);
+bool contains(const container& c, std::uint16_t value);
+
+// Sets `value` to `state`. Returns false if the container became empty.
+bool update(container& c, std::uint16_t value, bool state);
+
+// The smallest container holding the bits of `words` (`chunk_words` of them), or nothing if there are none.
+std::optional<container> make_container(const word_type* words);
+
+// Writes all `chunk_words` words of `c` to `words`.
+void fill_words(const container& c, word_type* words);
+
+std::optional<container> combine(const container& lhs, const container& rhs, operation op);
+
+bool equal(const container& lhs, const container& rhs);
+
+std::size_t memory_usage(const container& c);
+
+// Cursor over the set bits of a container: `slot` is an index into its values or runs, `value` the current bit.
+void first(const container& c, std::size_t& slot, std::uint16_t& value);
+// Returns false if there are no set bits after `value`.
+bool next(const container& c, std::size_t& slot, std::uint16_t& value);
+
+} // namespace bts::roaring
+
+// Bitset for large, sparse or clustered data.
+//
+// Positions are split into chunks of 2^16 bits and only chunks with set bits are stored, each in the
+// smallest of three containers: a sorted array of positions, a plain bitmap or a list of runs. A bitset
+// of 1e8 bits with a few thousand set takes a few kilobytes instead of 12 MB, and operations on it only
+// touch the chunks that have bits set.
+//
+// Iteration yields the positions of the set bits in increasing order.
+class compressed_bitset {
+public:
+  class const_iterator;
+  using iterator = const_iterator;
+  using value_type = std::size_t;
+
+  static constexpr std::size_t npos = -1;
+
+public:
+  compressed_bitset() = default;
+
+  // `size` zero bits.
+  explicit compressed_bitset(std::size_t size);
+  explicit compressed_bitset(const bitset::const_view& bits);
+
+  std::size_t size() const;
+  bool empty() const;
+
+  bool test(std::size_t index) const;
+  bool operator[](std::size_t index) const;
+
+  compressed_bitset& set(std::size_t index, bool value = true);
+  compressed_bitset& reset(std::size_t index);
+
+  std::size_t count() const;
+  bool all() const;
+  bool any() const;
+
+  compressed_bitset& operator&=(const compressed_bitset& other) &;
+  compressed_bitset& operator|=(const compressed_bitset& other) &;
+  compressed_bitset& operator^=(const compressed_bitset& other) &;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  template <typename visitor_type>
+  void for_each_set(visitor_type visitor) const;
+
+  // Dense copy of bits [offset, offset + count).
+  bitset to_bitset(std::size_t offset = 0, std::size_t count = npos) const;
+
+  // Approximate number of bytes of heap memory in use.
+  std::size_t memory_usage() const;
+
+  friend compressed_bitset operator&(const compressed_bitset& lhs, const compressed_bitset& rhs);
+  friend compressed_bitset operator|(const compressed_bitset& lhs, const compressed_bitset& rhs);
+  friend compressed_bitset operator^(const compressed_bitset& lhs, const compressed_bitset& rhs);
+
+  friend bool operator==(const compressed_bitset& lhs, const compressed_bitset& rhs);
+  friend bool operator!=(const compressed_bitset& lhs, const compressed_bitset& rhs);
+
+private:
+  void combine(const compressed_bitset& other, bts::roaring::operation op);
+
+private:
+  std::size_t _size = 0;
+  // Sorted by key.
+  std::vector<bts::roaring::chunk> _chunks;
+};
+
+class compressed_bitset::const_iterator {
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = std::size_t;
+
+  const_iterator() = default;
+
+  std::size_t operator*() const {
+    return (*_chunks)[_chunk].key * bts::roaring::chunk_bits + _value;
+  }
+
+  const_iterator& operator++() {
+    if (!bts::roaring::next((*_chunks)[_chunk].bits, _slot, _value)) {
+      ++_chunk;
+      start_chunk();
+    }
+    return *this;
+  }
+
+  const_iterator operator++(int) {
+    const_iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+
+  friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) {
+    return lhs._chunk == rhs._chunk && lhs._slot == rhs._slot && lhs._value == rhs._value;
+  }
+
+  friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) {
+    return !(lhs == rhs);
+  }
+
+private:
+  friend class compressed_bitset;
+
+  const_iterator(const std::vector<bts::roaring::chunk>* chunks, std::size_t chunk)
+      : _chunks(chunks)
+      , _chunk(chunk) {
+    start_chunk();
+  }
+
+  void start_chunk() {
+    if (_chunk < _chunks->size()) {
+      bts::roaring::first((*_chunks)[_chunk].bits, _slot, _value);
+    } else {
+      _slot = 0;
+      _value = 0;
+    }
+  }
+
+private:
+  const std::vector<bts::roaring::chunk>* _chunks = nullptr;
+  std::size_t _chunk = 0;
+  std::size_t _slot = 0;
+  std::uint16_t _value = 0;
+};
+
+template <typename visitor_type>
+void compressed_bitset::for_each_set(visitor_type visitor) const {
+  for (auto it = begin(); it != end(); ++it) {
+    visitor(*it);
+  }
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include "bitset-iterator.h"
+#include "bitset-reference.h"
+#include "bitset-view.h"
+#include "bts.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Bitset with a size known at compile time. Words are stored inline and every operation on the
+// bitset itself is constexpr; views of it can use everything `bitset_view` provides.
+//
+// Bits past `N` in the last word are always kept zero.
+template <std::size_t N>
+class fixed_bitset {
+public:
+  using word_type = bts::word_type;
+  using value_type = bool;
+  using reference = bitset_reference<word_type>;
+  using const_reference = bitset_reference<const word_type>;
+  using iterator = bitset_iterator<word_type>;
+  using const_iterator = bitset_iterator<const word_type>;
+  using view = bitset_view<word_type>;
+  using const_view = bitset_view<const word_type>;
+
+  static constexpr std::size_t npos = -1;
+  static constexpr std::size_t word_count = (N + bts::word_size - 1) / bts::word_size;
+
+public:
+  constexpr fixed_bitset() = default;
+
+  // Takes the first N characters of `str`, missing ones are zeros.
+  constexpr explicit fixed_bitset(std::string_view str) {
+    str = str.substr(0, std::min(str.size(), N));
+    for (std::size_t i = 0; i * bts::word_size < str.size(); ++i) {
+      _words[i] = bts::stow(str.substr(i * bts::word_size, bts::word_size));
+    }
+  }
+
+  static constexpr std::size_t size() {
+    return N;
+  }
+
+  static constexpr bool empty() {
+    return N == 0;
+  }
+
+  constexpr bool test(std::size_t index) const {
+    return (_words[index / bts::word_size] >> bit_shift(index)) & word_type(1);
+  }
+
+  constexpr bool operator[](std::size_t index) const {
+    return test(index);
+  }
+
+  reference operator[](std::size_t index) {
+    return begin()[index];
+  }
+
+  constexpr fixed_bitset& set(std::size_t index, bool value = true) {
+    word_type mask = word_type(1) << bit_shift(index);
+    word_type& word = _words[index / bts::word_size];
+    word = value ? (word | mask) : (word & ~mask);
+    return *this;
+  }
+
+  constexpr fixed_bitset& reset(std::size_t index) {
+    return set(index, false);
+  }
+
+  constexpr fixed_bitset& flip(std::size_t index) {
+    _words[index / bts::word_size] ^= word_type(1) << bit_shift(index);
+    return *this;
+  }
+
+  constexpr fixed_bitset& set() {
+    _words.fill(bts::word_ones);
+    clear_tail();
+    return *this;
+  }
+
+  constexpr fixed_bitset& reset() {
+    _words.fill(bts::word_zeros);
+    return *this;
+  }
+
+  constexpr fixed_bitset& flip() {
+    for (word_type& word : _words) {
+      word = ~word;
+    }
+    clear_tail();
+    return *this;
+  }
+
+  constexpr fixed_bitset& operator&=(const fixed_bitset& other) {
+    for (std::size_t i = 0; i < word_count; ++i) {
+      _words[i] &= other._words[i];
+    }
+    return *this;
+  }
+
+  constexpr fixed_bitset& operator|=(const fixed_bitset& other) {
+    for (std::size_t i = 0; i < word_count; ++i) {
+      _words[i] |= other._words[i];
+    }
+    return *this;
+  }
+
+  constexpr fixed_bitset& operator^=(const fixed_bitset& other) {
+    for (std::size_t i = 0; i < word_count; ++i) {
+      _words[i] ^= other._words[i];
+    }
+    return *this;
+  }
+
+  constexpr std::size_t count() const {
+    std::size_t res = 0;
+    for (word_type word : _words) {
+      res += std::popcount(word);
+    }
+    return res;
+  }
+
+  constexpr bool all() const {
+    return count() == N;
+  }
+
+  constexpr bool any() const {
+    for (word_type word : _words) {
+      if (word != bts::word_zeros) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  constexpr bool none() const {
+    return !any();
+  }
+
+  constexpr std::size_t find_first() const {
+    for (std::size_t i = 0; i < word_count; ++i) {
+      if (_words[i] != bts::word_zeros) {
+        return i * bts::word_size + std::countl_zero(_words[i]);
+      }
+    }
+    return npos;
+  }
+
+  constexpr const std::array<word_type, word_count>& words() const {
+    return _words;
+  }
+
+  operator view() {
+    return {_words.data(), N};
+  }
+
+  operator const_view() const {
+    return {_words.data(), N};
+  }
+
+  view subview(std::size_t offset = 0, std::size_t count = npos) {
+    return view(*this).subview(offset, count);
+  }
+
+  const_view subview(std::size_t offset = 0, std::size_t count = npos) const {
+    return const_view(*this).subview(offset, count);
+  }
+
+  iterator begin() {
+    return view(*this).begin();
+  }
+
+  const_iterator begin() const {
+    return const_view(*this).begin();
+  }
+
+  iterator end() {
+    return view(*this).end();
+  }
+
+  const_iterator end() const {
+    return const_view(*this).end();
+  }
+
+  std::string to_string() const {
+    return const_view(*this).to_string();
+  }
+
+  friend constexpr fixed_bitset operator&(const fixed_bitset& lhs, const fixed_bitset& rhs) {
+    fixed_bitset res = lhs;
+    res &= rhs;
+    return res;
+  }
+
+  friend constexpr fixed_bitset operator|(const fixed_bitset& lhs, const fixed_bitset& rhs) {
+    fixed_bitset res = lhs;
+    res |= rhs;
+    return res;
+  }
+
+  friend constexpr fixed_bitset operator^(const fixed_bitset& lhs, const fixed_bitset& rhs) {
+    fixed_bitset res = lhs;
+    res ^= rhs;
+    return res;
+  }
+
+  friend constexpr fixed_bitset operator~(const fixed_bitset& bs) {
+    fixed_bitset res = bs;
+    res.flip();
+    return res;
+  }
+
+  friend constexpr bool operator==(const fixed_bitset& lhs, const fixed_bitset& rhs) = default;
+
+private:
+  static constexpr std::size_t bit_shift(std::size_t index) {
+    return bts::word_size - index % bts::word_size - 1;
+  }
+
+  constexpr void clear_tail() {
+    if constexpr (N % bts::word_size != 0) {
+      _words.back() = bts::get_subword(_words.back(), 0, N % bts::word_size);
+    }
+  }
+
+private:
+  std::array<word_type, word_count> _words{};
+};
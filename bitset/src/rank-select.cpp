@@ -0,0 +1,110 @@
+#include "rank-select.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+// Position of the set bit of `word` preceded by `rank` other set bits, counting from the most significant.
+std::size_t select_in_word(bts::word_type word, std::size_t rank) {
+  std::size_t res = 0;
+  for (std::size_t width = bts::word_size / 2; width > 0; width /= 2) {
+    const auto high = static_cast<std::size_t>(std::popcount(word >> (bts::word_size - width)));
+    if (rank >= high) {
+      rank -= high;
+      word <<= width;
+      res += width;
+    }
+  }
+  return res;
+}
+
+} // namespace
+
+rank_select_index::rank_select_index(const bitset::const_view& bits)
+    : _bits(bits) {
+  rebuild(bits);
+}
+
+std::size_t rank_select_index::size() const {
+  return _bits.size();
+}
+
+std::size_t rank_select_index::count() const {
+  return _count;
+}
+
+std::size_t rank_select_index::rank1(std::size_t pos) const {
+  const std::size_t block = pos / block_bits;
+  std::size_t res = _superblocks[pos / superblock_bits] + _blocks[block];
+  for (std::size_t i = block * block_words; i < pos / bts::word_size; ++i) {
+    res += std::popcount(word(i));
+  }
+  if (pos % bts::word_size != 0) {
+    res += std::popcount(bts::get_subword(word(pos / bts::word_size), 0, pos % bts::word_size));
+  }
+  return res;
+}
+
+std::size_t rank_select_index::rank0(std::size_t pos) const {
+  return pos - rank1(pos);
+}
+
+std::size_t rank_select_index::select1(std::size_t rank) const {
+  if (rank >= _count) {
+    return npos;
+  }
+  const std::size_t superblock =
+      std::upper_bound(_superblocks.begin(), _superblocks.end(), rank) - _superblocks.begin() - 1;
+  rank -= _superblocks[superblock];
+
+  auto first_block = _blocks.begin() + static_cast<std::ptrdiff_t>(superblock * superblock_blocks);
+  auto last_block = _blocks.begin() + static_cast<std::ptrdiff_t>(
+                                          std::min(_blocks.size(), (superblock + 1) * superblock_blocks)
+                                      );
+  const std::size_t block = std::upper_bound(first_block, last_block, rank) - _blocks.begin() - 1;
+  rank -= _blocks[block];
+
+  for (std::size_t i = block * block_words;; ++i) {
+    const bts::word_type w = word(i);
+    const auto ones = static_cast<std::size_t>(std::popcount(w));
+    if (rank < ones) {
+      return i * bts::word_size + select_in_word(w, rank);
+    }
+    rank -= ones;
+  }
+}
+
+void rank_select_index::update(std::size_t first_changed) {
+  const std::size_t words = (size() + bts::word_size - 1) / bts::word_size;
+  const std::size_t first_superblock = std::min(first_changed, size()) / superblock_bits;
+  std::size_t total = _superblocks[first_superblock];
+
+  for (std::size_t block = first_superblock * superblock_blocks; block < _blocks.size(); ++block) {
+    if (block % superblock_blocks == 0) {
+      _superblocks[block / superblock_blocks] = total;
+    }
+    _blocks[block] = static_cast<std::uint16_t>(total - _superblocks[block / superblock_blocks]);
+    for (std::size_t i = block * block_words; i < std::min(words, (block + 1) * block_words); ++i) {
+      total += std::popcount(word(i));
+    }
+  }
+  _count = total;
+}
+
+void rank_select_index::rebuild(const bitset::const_view& bits) {
+  _bits = bitset_view_expression(bits);
+  _superblocks.assign(bits.size() / superblock_bits + 1, 0);
+  _blocks.assign(bits.size() / block_bits + 1, 0);
+  update();
+}
+
+std::size_t rank_select_index::memory_usage() const {
+  return _superblocks.capacity() * sizeof(std::uint64_t) + _blocks.capacity() * sizeof(std::uint16_t);
+}
+
+bts::word_type rank_select_index::word(std::size_t index) const {
+  const std::size_t pos = index * bts::word_size;
+  const bts::word_type res = _bits.word(index);
+  return size() - pos >= bts::word_size ? res : bts::get_subword(res, 0, size() - pos);
+}
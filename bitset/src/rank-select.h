@@ -0,0 +1,62 @@
+#pragma once
+
+#include "bitset-expression.h"
+#include "bitset.h"
+#include "bts.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Auxiliary index answering rank and select queries over a bitset.
+//
+// Set bits are counted per superblock of 2^16 bits (absolute 64-bit counts) and per block of 512 bits
+// (16-bit counts relative to the superblock), about 3.2% on top of the bits themselves. `rank1` is
+// two lookups and at most eight word popcounts; `select1` is two binary searches and at most eight
+// word popcounts.
+//
+// The index refers to the bits like a view does: it must not outlive them, and after they change it
+// has to be updated before the next query.
+class rank_select_index {
+public:
+  static constexpr std::size_t npos = -1;
+  static constexpr std::size_t block_bits = 512;
+  static constexpr std::size_t superblock_bits = std::size_t(1) << 16;
+
+public:
+  explicit rank_select_index(const bitset::const_view& bits);
+
+  std::size_t size() const;
+  // Number of set bits.
+  std::size_t count() const;
+
+  // Number of set bits in [0, pos), for pos in [0, size()].
+  std::size_t rank1(std::size_t pos) const;
+  // Number of zero bits in [0, pos), for pos in [0, size()].
+  std::size_t rank0(std::size_t pos) const;
+
+  // Position of the set bit with `rank1` equal to `rank`, or `npos` if there are not that many.
+  std::size_t select1(std::size_t rank) const;
+
+  // Recounts after bits at positions `first_changed` and later were modified in place.
+  void update(std::size_t first_changed = 0);
+  // Indexes other bits, e.g. after the bitset was resized.
+  void rebuild(const bitset::const_view& bits);
+
+  // Number of bytes of heap memory used by the index.
+  std::size_t memory_usage() const;
+
+private:
+  static constexpr std::size_t block_words = block_bits / bts::word_size;
+  static constexpr std::size_t superblock_blocks = superblock_bits / block_bits;
+
+  // Word `index` of the bits, with the bits past the end cleared.
+  bts::word_type word(std::size_t index) const;
+
+private:
+  bitset_view_expression _bits;
+  std::size_t _count = 0;
+  // Set bits before every superblock and block that starts at or before the end.
+  std::vector<std::uint64_t> _superblocks;
+  std::vector<std::uint16_t> _blocks;
+};
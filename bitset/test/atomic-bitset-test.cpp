@@ -0,0 +1,113 @@
+#include "atomic-bitset.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+TEST_CASE("atomic bitset single thread") {
+  const bitset source("1011000000000000000000000000000000000000000000000000000000000000000000000101");
+  atomic_bitset bs(source);
+  bitset expected = source;
+
+  CHECK(bs.size() == source.size());
+  CHECK(bs.word_count() == 2);
+  CHECK(bs.count() == source.count());
+  CHECK(bs.snapshot() == source);
+  CHECK(bs.view() == source);
+
+  CHECK(bs.test(0));
+  CHECK_FALSE(bs.test(1));
+  CHECK_FALSE(bs.test_and_set(1));
+  CHECK(bs.test_and_set(1));
+  CHECK(bs.test_and_reset(0));
+  CHECK_FALSE(bs.test_and_reset(0));
+  CHECK_FALSE(bs.test_and_flip(70));
+  CHECK(bs.test(70));
+  expected[0] = false;
+  expected[1] = true;
+  expected[70] = true;
+
+  bts::word_type previous = bs.load_word(1);
+  CHECK(bs.fetch_or_word(1, bts::word_type(0xf) << 60) == previous);
+  expected.subview(64, 4).set();
+  previous = bs.load_word(0);
+  CHECK(bs.fetch_and_word(0, bts::word_ones >> 1) == previous);
+
+  CHECK(bs.snapshot() == expected);
+  CHECK(bs.count() == expected.count());
+}
+
+TEST_CASE("atomic bitset move") {
+  const bitset source("10110000000000000000000000000000000000000000000000000000000000000000001");
+  atomic_bitset bs(source);
+
+  atomic_bitset moved(std::move(bs));
+  CHECK(moved.snapshot() == source);
+  CHECK(bs.size() == 0);
+  CHECK(bs.word_count() == 0);
+  CHECK(bs.count() == 0);
+  CHECK(bs.snapshot().empty());
+  CHECK(bs.view().empty());
+
+  bs = atomic_bitset(3);
+  bs = std::move(moved);
+  CHECK(bs.view() == source);
+  CHECK(moved.size() == 0);
+  CHECK(moved.count() == 0);
+  CHECK(moved.snapshot().empty());
+}
+
+TEST_CASE("atomic bitset concurrent writers") {
+  constexpr std::size_t size = 100000;
+  constexpr std::size_t threads = 4;
+  constexpr std::size_t updates = 50000;
+
+  atomic_bitset bs(size);
+  std::atomic<std::size_t> first_sets = 0;
+  std::vector<std::vector<std::size_t>> touched(threads);
+
+  std::vector<std::thread> workers;
+  for (std::size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      std::mt19937 rng(static_cast<unsigned>(t));
+      std::size_t local_first_sets = 0;
+      for (std::size_t i = 0; i < updates; ++i) {
+        // Threads share most of the range, so they keep hitting the same words.
+        std::size_t index = rng() % (size / 2) + t * 1000;
+        touched[t].push_back(index);
+        if (!bs.test_and_set(index, std::memory_order_relaxed)) {
+          ++local_first_sets;
+        }
+        if (i % 64 == 0) {
+          bs.fetch_or_word(size / bts::word_size - 1, bts::word_type(1) << (63 - t), std::memory_order_relaxed);
+        }
+        if (i % 128 == 0) {
+          static_cast<void>(bs.count());
+        }
+      }
+      first_sets += local_first_sets;
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  bitset expected(size, false);
+  for (const auto& indices : touched) {
+    for (std::size_t index : indices) {
+      expected[index] = true;
+    }
+  }
+  for (std::size_t t = 0; t < threads; ++t) {
+    expected[(size / bts::word_size - 1) * bts::word_size + t] = true;
+  }
+
+  CHECK(bs.snapshot() == expected);
+  CHECK(bs.count() == expected.count());
+  CHECK(first_sets + threads == expected.count());
+}
@@ -6,9 +6,15 @@
 #include <catch2/generators/catch_generators.hpp>
 #include <catch2/matchers/catch_matchers.hpp>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
 #include <random>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 TEST_CASE("bitset default constructor") {
   bitset bs;
@@ -160,3 +166,217 @@ TEST_CASE("ostream << bitset") {
   ss << bs;
   CHECK(ss.str() == str);
 }
+
+TEST_CASE("bitset move constructor and assignment") {
+  std::string str = "11110110111010000100101111101000011011111111000001100110010010001011100100110101";
+  str += str;
+  str += str;
+
+  SECTION("constructor") {
+    bitset bs(str);
+    auto data = bs.begin();
+    bitset moved(std::move(bs));
+
+    CHECK_THAT(moved, bitset_equals_string(str));
+    CHECK(moved.begin() == data);
+    CHECK(bs.empty());
+  }
+
+  SECTION("assignment") {
+    bitset bs(str);
+    auto data = bs.begin();
+    bitset moved("101");
+    moved = std::move(bs);
+
+    CHECK_THAT(moved, bitset_equals_string(str));
+    CHECK(moved.begin() == data);
+  }
+
+  STATIC_CHECK(std::is_nothrow_move_constructible_v<bitset>);
+  STATIC_CHECK(std::is_nothrow_move_assignable_v<bitset>);
+}
+
+TEST_CASE("bitset reserve and capacity") {
+  bitset bs("1101101");
+  CHECK(bs.capacity() >= bs.size());
+
+  bs.reserve(1000);
+  CHECK(bs.capacity() >= 1000);
+  CHECK_THAT(bs, bitset_equals_string("1101101"));
+
+  auto data = bs.begin();
+  bs <<= 900;
+  CHECK(bs.begin() == data);
+  CHECK_THAT(bs, bitset_equals_string("1101101" + std::string(900, '0')));
+}
+
+TEST_CASE("bitset resize") {
+  bool bit = GENERATE(false, true);
+  CAPTURE(bit);
+
+  std::string str = "1101101";
+  bitset bs(str);
+
+  bs.resize(100, bit);
+  str.append(93, bit ? '1' : '0');
+  CHECK_THAT(bs, bitset_equals_string(str));
+
+  bs.resize(70, !bit);
+  str.resize(70);
+  CHECK_THAT(bs, bitset_equals_string(str));
+
+  bs.resize(130, !bit);
+  str.append(60, bit ? '0' : '1');
+  CHECK_THAT(bs, bitset_equals_string(str));
+
+  bs.resize(0);
+  CHECK(bs.empty());
+}
+
+TEST_CASE("bitset grows after being filled") {
+  bitset bs(7, true);
+  bs <<= 5;
+  CHECK_THAT(bs, bitset_equals_string("111111100000"));
+}
+
+TEST_CASE("bitset push_back") {
+  std::mt19937 rng(5);
+  std::string str;
+  bitset bs;
+
+  for (std::size_t i = 0; i < 1000; ++i) {
+    bool bit = rng() % 2 == 0;
+    bs.push_back(bit);
+    str.push_back(bit ? '1' : '0');
+  }
+
+  CHECK_THAT(bs, bitset_equals_string(str));
+  CHECK(bs.capacity() < 4 * bs.size());
+}
+
+TEST_CASE("small bitsets") {
+  const std::size_t small_capacity = bitset().capacity();
+  CHECK(small_capacity >= 128);
+
+  std::string_view str = "11110110111010000100101111101000011011111111000001100110010010001011100100110101";
+  bitset bs(str);
+  CHECK(bs.capacity() == small_capacity);
+
+  SECTION("copy and move") {
+    bitset copy = bs;
+    bitset moved = std::move(bs);
+    CHECK_THAT(copy, bitset_equals_string(str));
+    CHECK_THAT(moved, bitset_equals_string(str));
+
+    moved.flip();
+    CHECK_THAT(copy, bitset_equals_string(str));
+  }
+
+  SECTION("swap with a large bitset") {
+    std::string large_str(300, '1');
+    bitset large(large_str);
+    CHECK(large.capacity() > small_capacity);
+
+    swap(bs, large);
+    CHECK_THAT(bs, bitset_equals_string(large_str));
+    CHECK_THAT(large, bitset_equals_string(str));
+    CHECK(large.capacity() == small_capacity);
+  }
+
+  SECTION("growing past the inline storage") {
+    std::string expected(str);
+    for (std::size_t i = 0; i < 200; ++i) {
+      bs.push_back(i % 3 == 0);
+      expected.push_back(i % 3 == 0 ? '1' : '0');
+    }
+    CHECK(bs.capacity() > small_capacity);
+    CHECK_THAT(bs, bitset_equals_string(expected));
+  }
+}
+
+namespace {
+
+class counting_resource : public std::pmr::memory_resource {
+public:
+  std::size_t allocated = 0;
+  std::size_t allocations = 0;
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    CHECK(alignment == bitset::storage_alignment);
+    void* res = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    CHECK(reinterpret_cast<std::uintptr_t>(res) % bitset::storage_alignment == 0);
+    allocated += bytes;
+    ++allocations;
+    return res;
+  }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+    allocated -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+} // namespace
+
+TEST_CASE("bitset memory resource") {
+  counting_resource resource;
+  std::string str(300, '0');
+  for (std::size_t i = 0; i < str.size(); i += 7) {
+    str[i] = '1';
+  }
+
+  SECTION("default") {
+    CHECK(bitset().get_memory_resource() == std::pmr::get_default_resource());
+    CHECK(bitset(str).get_memory_resource() == std::pmr::get_default_resource());
+  }
+
+  SECTION("construction and growth") {
+    {
+      bitset bs(str, &resource);
+      CHECK(bs.get_memory_resource() == &resource);
+      CHECK(resource.allocations == 1);
+      CHECK_THAT(bs, bitset_equals_string(str));
+
+      bs.resize(5000, true);
+      CHECK(resource.allocations == 2);
+      CHECK(resource.allocated >= 5000 / 8);
+
+      bitset small(10, true, &resource);
+      CHECK(resource.allocations == 2);
+    }
+    CHECK(resource.allocated == 0);
+  }
+
+  SECTION("copies keep their own resource") {
+    bitset source(str);
+    bitset copy(source, &resource);
+    CHECK(copy.get_memory_resource() == &resource);
+    CHECK(bitset(copy).get_memory_resource() == std::pmr::get_default_resource());
+
+    bitset assigned(&resource);
+    assigned = source;
+    CHECK(assigned.get_memory_resource() == &resource);
+    assigned = source & ~copy;
+    CHECK(assigned.get_memory_resource() == &resource);
+    CHECK_FALSE(assigned.any());
+
+    bitset moved = std::move(copy);
+    CHECK(moved.get_memory_resource() == &resource);
+    CHECK_THAT(moved, bitset_equals_string(str));
+  }
+
+  SECTION("monotonic arena") {
+    std::array<std::byte, 1 << 14> buffer;
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    for (std::size_t i = 0; i < 20; ++i) {
+      bitset tmp(str, &arena);
+      tmp &= bitset(str.size(), true, &arena);
+      CHECK(tmp.count() == (str.size() + 6) / 7);
+    }
+  }
+}
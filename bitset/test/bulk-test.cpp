@@ -0,0 +1,81 @@
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST_CASE("bulk index operations") {
+  std::size_t size = GENERATE(1, 64, 1000, 100000);
+  std::size_t offset = GENERATE(0, 13);
+  std::size_t count = GENERATE(0, 1, 50, 5000);
+  bool sorted = GENERATE(false, true);
+  CAPTURE(size, offset, count, sorted);
+
+  std::mt19937 rng(static_cast<unsigned>(size + count));
+  std::string str = random_string(size + offset + 5, rng);
+  std::vector<std::uint32_t> indices(count);
+  for (auto& index : indices) {
+    index = static_cast<std::uint32_t>(rng() % size);
+  }
+  if (sorted) {
+    std::sort(indices.begin(), indices.end());
+  }
+
+  bitset bs(str);
+  auto view = bs.subview(offset, size);
+
+  SECTION("set and reset") {
+    std::string expected = str;
+    for (auto index : indices) {
+      expected[offset + index] = '1';
+    }
+    view.set_bits(indices);
+    CHECK_THAT(bs, bitset_equals_string(expected));
+
+    for (auto index : indices) {
+      expected[offset + index] = '0';
+    }
+    view.reset_bits(indices);
+    CHECK_THAT(bs, bitset_equals_string(expected));
+  }
+
+  SECTION("test and gather") {
+    std::string expected(count, '0');
+    for (std::size_t i = 0; i < count; ++i) {
+      expected[i] = str[offset + indices[i]];
+    }
+
+    auto out = std::make_unique<bool[]>(count);
+    view.test_bits(indices, std::span(out.get(), count));
+    for (std::size_t i = 0; i < count; ++i) {
+      REQUIRE(out[i] == (expected[i] == '1'));
+    }
+
+    bitset packed(count + 3, true);
+    view.gather(indices, packed.subview(3));
+    CHECK_THAT(packed, bitset_equals_string("111" + expected));
+  }
+}
+
+TEST_CASE("bulk index operations on bitset") {
+  bitset bs(200, false);
+  std::vector<std::uint32_t> indices = {5, 199, 64, 5, 0, 128};
+  bs.set_bits(indices);
+  CHECK(bs.count() == 5);
+  CHECK(bs[0]);
+  CHECK(bs[199]);
+
+  std::vector<std::uint32_t> probes = {0, 1, 64, 65, 199};
+  CHECK_THAT(bs.gather(probes), bitset_equals_string("10101"));
+
+  bs.reset_bits(indices);
+  CHECK_FALSE(bs.any());
+  CHECK(bs.gather({}).empty());
+}
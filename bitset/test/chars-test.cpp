@@ -0,0 +1,155 @@
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <charconv>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+namespace {
+
+std::string slow_to_string(bts::word_type word, std::size_t size) {
+  std::string res;
+  for (std::size_t i = 0; i < size; ++i) {
+    res += ((word >> (bts::word_size - 1 - i)) & 1) != 0 ? '1' : '0';
+  }
+  return res;
+}
+
+} // namespace
+
+TEST_CASE("word conversions") {
+  STATIC_REQUIRE(bts::stow("") == bts::word_zeros);
+  STATIC_REQUIRE(bts::stow("1") == bts::word_type(1) << 63);
+  STATIC_REQUIRE(bts::stow("0000000110000000") == bts::word_type(0x0180) << 48);
+  STATIC_REQUIRE(bts::binary_prefix("0110100101x") == 10);
+
+  std::mt19937 rng(17);
+  std::size_t size = GENERATE(range(0, 65));
+  CAPTURE(size);
+
+  std::string str = random_string(size, rng);
+  bts::word_type word = bts::stow(str);
+  CHECK(slow_to_string(word, bts::word_size) == str + std::string(bts::word_size - size, '0'));
+
+  std::string formatted(size, 'x');
+  bts::wtos(word, size, formatted.data());
+  CHECK(formatted == str);
+
+  CHECK(bts::binary_prefix(str) == size);
+  if (size > 0) {
+    std::string invalid = str;
+    invalid[size / 2] = '2';
+    CHECK(bts::binary_prefix(invalid) == size / 2);
+
+    // Characters other than '1' are read as zeros.
+    invalid = str;
+    for (std::size_t i = 0; i < size; i += 3) {
+      if (invalid[i] == '0') {
+        invalid[i] = "a/ \xff"[i % 4];
+      }
+    }
+    CHECK(bts::stow(invalid) == word);
+  }
+}
+
+TEST_CASE("formatting views") {
+  std::mt19937 rng(5);
+  std::string str = random_string(10000, rng);
+  const bitset bs(str);
+
+  std::size_t offset = GENERATE(0, 1, 63, 64, 100);
+  std::size_t count = GENERATE(0, 7, 64, 130, 9000);
+  CAPTURE(offset, count);
+  auto view = bs.subview(offset, count);
+  std::string expected = str.substr(offset, count);
+
+  CHECK(view.to_string() == expected);
+
+  std::ostringstream out;
+  out << view;
+  CHECK(out.str() == expected);
+
+  std::string buffer(count + 2, 'x');
+  auto [ptr, ec] = to_chars(buffer.data(), buffer.data() + buffer.size(), view);
+  CHECK(ec == std::errc());
+  CHECK(ptr == buffer.data() + count);
+  CHECK(buffer == expected + "xx");
+
+  if (count > 0) {
+    auto result = to_chars(buffer.data(), buffer.data() + count - 1, view);
+    CHECK(result.ec == std::errc::value_too_large);
+  }
+}
+
+TEST_CASE("parsing into views") {
+  std::mt19937 rng(9);
+  std::string original = random_string(300, rng);
+  std::string input = random_string(300, rng);
+
+  std::size_t offset = GENERATE(0, 3, 64, 70);
+  std::size_t count = GENERATE(1, 64, 100, 200);
+  CAPTURE(offset, count);
+
+  bitset bs(original);
+  auto view = bs.subview(offset, count);
+
+  SECTION("success") {
+    auto [ptr, ec] = from_chars(input.data(), input.data() + input.size(), view);
+    CHECK(ec == std::errc());
+    CHECK(ptr == input.data() + count);
+
+    std::string expected = original;
+    expected.replace(offset, count, input.substr(0, count));
+    CHECK_THAT(bs, bitset_equals_string(expected));
+  }
+
+  SECTION("too short") {
+    auto [ptr, ec] = from_chars(input.data(), input.data() + count - 1, view);
+    CHECK(ec == std::errc::invalid_argument);
+    CHECK(ptr == input.data() + count - 1);
+    CHECK_THAT(bs, bitset_equals_string(original));
+  }
+
+  SECTION("invalid character") {
+    input[count / 2] = ' ';
+    auto [ptr, ec] = from_chars(input.data(), input.data() + input.size(), view);
+    CHECK(ec == std::errc::invalid_argument);
+    CHECK(ptr == input.data() + count / 2);
+    CHECK_THAT(bs, bitset_equals_string(original));
+  }
+}
+
+TEST_CASE("parsing into bitset") {
+  bitset bs("101");
+
+  SECTION("stops at the first non-digit") {
+    std::string input = "1100110011001100110011001100110011001100110011001100110011001100111 tail";
+    auto [ptr, ec] = from_chars(input.data(), input.data() + input.size(), bs);
+    CHECK(ec == std::errc());
+    CHECK(std::string_view(ptr) == " tail");
+    CHECK_THAT(bs, bitset_equals_string(input.substr(0, input.find(' '))));
+  }
+
+  SECTION("no digits") {
+    std::string input = "x101";
+    auto [ptr, ec] = from_chars(input.data(), input.data() + input.size(), bs);
+    CHECK(ec == std::errc::invalid_argument);
+    CHECK(ptr == input.data());
+    CHECK_THAT(bs, bitset_equals_string("101"));
+  }
+
+  SECTION("round trip") {
+    std::mt19937 rng(3);
+    std::string input = random_string(1000, rng);
+    from_chars(input.data(), input.data() + input.size(), bs);
+
+    std::string output(1000, 'x');
+    to_chars(output.data(), output.data() + output.size(), bs);
+    CHECK(output == input);
+  }
+}
@@ -0,0 +1,184 @@
+#include "bitset.h"
+#include "compressed-bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t chunk_size = bts::roaring::chunk_bits;
+
+enum class density {
+  SPARSE,
+  DENSE,
+  CLUSTERED,
+};
+
+bitset random_bitset(std::size_t size, density kind, std::mt19937& rng) {
+  bitset res(size, false);
+  switch (kind) {
+  case density::SPARSE:
+    for (std::size_t i = 0; i < size / 1000; ++i) {
+      res[rng() % size] = true;
+    }
+    break;
+  case density::DENSE:
+    for (std::size_t i = 0; i < size; ++i) {
+      res[i] = rng() % 3 == 0;
+    }
+    break;
+  case density::CLUSTERED:
+    for (std::size_t i = 0; i < size / 5000; ++i) {
+      std::size_t first = rng() % size;
+      res.subview(first, rng() % 3000).set();
+    }
+    break;
+  }
+  return res;
+}
+
+std::vector<std::size_t> set_positions(const bitset& bs) {
+  std::vector<std::size_t> res;
+  bs.for_each_set([&res](std::size_t i) { res.push_back(i); });
+  return res;
+}
+
+} // namespace
+
+TEST_CASE("compressed bitset matches dense bitset") {
+  auto kind = GENERATE(density::SPARSE, density::DENSE, density::CLUSTERED);
+  std::size_t size = GENERATE(0, 100, chunk_size, 3 * chunk_size + 17);
+  CAPTURE(kind, size);
+
+  std::mt19937 rng(static_cast<unsigned>(size) + static_cast<unsigned>(kind));
+  const bitset a = random_bitset(size, kind, rng);
+  const bitset b = random_bitset(size, density::CLUSTERED, rng);
+  const compressed_bitset ca(a);
+  const compressed_bitset cb(b);
+
+  SECTION("conversion") {
+    CHECK(ca.size() == size);
+    CHECK(ca.count() == a.count());
+    CHECK(ca.any() == a.any());
+    CHECK(ca.to_bitset() == a);
+    CHECK(compressed_bitset(ca.to_bitset()) == ca);
+  }
+
+  SECTION("iteration") {
+    std::vector<std::size_t> expected = set_positions(a);
+    CHECK(std::vector<std::size_t>(ca.begin(), ca.end()) == expected);
+
+    std::vector<std::size_t> visited;
+    ca.for_each_set([&visited](std::size_t i) { visited.push_back(i); });
+    CHECK(visited == expected);
+  }
+
+  SECTION("operations") {
+    CHECK((ca & cb).to_bitset() == bitset(a & b));
+    CHECK((ca | cb).to_bitset() == bitset(a | b));
+    CHECK((ca ^ cb).to_bitset() == bitset(a ^ b));
+    CHECK((ca ^ ca).count() == 0);
+    CHECK((ca & cb) == compressed_bitset(bitset(a & b)));
+  }
+
+  SECTION("dense subviews") {
+    std::size_t offset = GENERATE(0, 1, 65, chunk_size - 3, chunk_size + 64);
+    std::size_t count = GENERATE(0, 10, chunk_size, bitset::npos);
+    CAPTURE(offset, count);
+    CHECK(ca.to_bitset(offset, count) == bitset(a.subview(offset, count)));
+  }
+}
+
+TEST_CASE("compressed bitset single bits") {
+  compressed_bitset bs(4 * chunk_size);
+  bitset expected(4 * chunk_size, false);
+
+  SECTION("grows into a bitmap and back") {
+    std::mt19937 rng(1);
+    std::vector<std::size_t> positions;
+    for (std::size_t i = 0; i < bts::roaring::array_limit + 100; ++i) {
+      positions.push_back(chunk_size + rng() % chunk_size);
+    }
+    for (std::size_t pos : positions) {
+      bs.set(pos);
+      expected[pos] = true;
+    }
+    CHECK(bs.count() == expected.count());
+    CHECK(bs.to_bitset() == expected);
+
+    for (std::size_t pos : positions) {
+      bs.reset(pos);
+      expected[pos] = false;
+      REQUIRE(bs.test(pos) == expected[pos]);
+    }
+    CHECK_FALSE(bs.any());
+    CHECK(bs == compressed_bitset(4 * chunk_size));
+  }
+
+  SECTION("runs") {
+    expected.subview(10, 50000).set();
+    expected.subview(2 * chunk_size - 5, 100).set();
+    bs = compressed_bitset(expected);
+
+    bs.reset(20);
+    bs.set(60000);
+    bs.set(2 * chunk_size - 6);
+    expected[20] = false;
+    expected[60000] = true;
+    expected[2 * chunk_size - 6] = true;
+
+    CHECK(bs.to_bitset() == expected);
+    CHECK(bs.count() == expected.count());
+    CHECK(bs[2 * chunk_size - 6]);
+    CHECK_FALSE(bs[20]);
+  }
+
+  SECTION("runs are split and merged in place") {
+    expected.subview(100, 1000).set();
+    expected.subview(2000, 1000).set();
+    bs = compressed_bitset(expected);
+    const std::size_t memory = bs.memory_usage();
+
+    for (std::size_t pos = 1100; pos < 2000; ++pos) {
+      bs.set(pos);
+      expected[pos] = true;
+    }
+    for (std::size_t pos : {100, 2999, 1500}) {
+      bs.reset(pos);
+      expected[pos] = false;
+    }
+
+    CHECK(bs.to_bitset() == expected);
+    CHECK(bs.count() == expected.count());
+    CHECK(bs.memory_usage() <= memory);
+  }
+
+  SECTION("all") {
+    compressed_bitset full(bitset(3 * chunk_size + 5, true));
+    CHECK(full.all());
+    full.reset(chunk_size);
+    CHECK_FALSE(full.all());
+  }
+}
+
+TEST_CASE("compressed bitset memory") {
+  const std::size_t size = 100'000'000;
+  std::mt19937 rng(7);
+
+  bitset sparse(size, false);
+  for (std::size_t i = 0; i < 5000; ++i) {
+    sparse[rng() % size] = true;
+  }
+  compressed_bitset compressed(sparse);
+  CHECK(compressed.memory_usage() * 100 < size / 8);
+  CHECK(compressed.count() == sparse.count());
+
+  bitset runs(size, false);
+  runs.subview(1000, size / 2).set();
+  CHECK(compressed_bitset(runs).memory_usage() * 100 < size / 8);
+}
@@ -0,0 +1,130 @@
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+namespace {
+
+template <typename F>
+std::string combine(const std::string& a, const std::string& b, const std::string& c, F f) {
+  std::string res(a.size(), '0');
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    res[i] = f(a[i] == '1', b[i] == '1', c[i] == '1') ? '1' : '0';
+  }
+  return res;
+}
+
+} // namespace
+
+TEST_CASE("expressions over bitsets") {
+  std::size_t size = GENERATE(0, 1, 7, 64, 80, 200);
+  CAPTURE(size);
+
+  std::mt19937 rng(size);
+  std::string a_str = random_string(size, rng);
+  std::string b_str = random_string(size, rng);
+  std::string c_str = random_string(size, rng);
+  const bitset a(a_str);
+  const bitset b(b_str);
+  const bitset c(c_str);
+
+  SECTION("conversion to bitset") {
+    bitset res = a & b | ~c;
+    CHECK_THAT(res, bitset_equals_string(combine(a_str, b_str, c_str, [](bool x, bool y, bool z) {
+                 return (x && y) || !z;
+               })));
+
+    res = a ^ (b & c);
+    CHECK_THAT(res, bitset_equals_string(combine(a_str, b_str, c_str, [](bool x, bool y, bool z) {
+                 return x != (y && z);
+               })));
+  }
+
+  SECTION("reductions") {
+    std::string expected = combine(a_str, b_str, c_str, [](bool x, bool y, bool z) { return (x | y) & !z; });
+    auto expression = (a | b) & ~c;
+
+    CHECK(expression.size() == size);
+    CHECK(expression.count() == std::ranges::count(expected, '1'));
+    CHECK(expression.any() == (expected.find('1') != std::string::npos));
+    CHECK(expression.all() == (expected.find('0') == std::string::npos));
+    CHECK(expression.to_string() == expected);
+    CHECK(expression == bitset(expected));
+    CHECK((a | ~a).all());
+    CHECK_FALSE((a & ~a).any());
+  }
+
+  SECTION("compound assignment") {
+    bitset res = a;
+    res &= b | c;
+    CHECK_THAT(res, bitset_equals_string(combine(a_str, b_str, c_str, [](bool x, bool y, bool z) {
+                 return x && (y || z);
+               })));
+
+    res = a;
+    res |= b & c;
+    CHECK_THAT(res, bitset_equals_string(combine(a_str, b_str, c_str, [](bool x, bool y, bool z) {
+                 return x || (y && z);
+               })));
+
+    res = a;
+    res ^= ~b;
+    CHECK_THAT(res, bitset_equals_string(combine(a_str, b_str, c_str, [](bool x, bool y, bool) {
+                 return x != !y;
+               })));
+  }
+}
+
+TEST_CASE("expressions over unaligned views") {
+  std::mt19937 rng(7);
+  std::string a_str = random_string(300, rng);
+  std::string b_str = random_string(300, rng);
+  const bitset a(a_str);
+  const bitset b(b_str);
+
+  auto [a_offset, b_offset, count] = GENERATE(table<std::size_t, std::size_t, std::size_t>({
+      {0, 0, 200},
+      {3, 0, 150},
+      {0, 5, 150},
+      {13, 77, 200},
+      {64, 128, 100},
+      {250, 1, 50},
+  }));
+  CAPTURE(a_offset, b_offset, count);
+
+  std::string expected(count, '0');
+  for (std::size_t i = 0; i < count; ++i) {
+    expected[i] = (a_str[a_offset + i] == '1') != (b_str[b_offset + i] == '0') ? '1' : '0';
+  }
+
+  bitset res = a.subview(a_offset, count) ^ ~b.subview(b_offset, count);
+  CHECK_THAT(res, bitset_equals_string(expected));
+  CHECK((a.subview(a_offset, count) ^ ~b.subview(b_offset, count)).count() == std::ranges::count(expected, '1'));
+  CHECK((a.subview(a_offset, count) ^ ~b.subview(b_offset, count)).to_string() == expected);
+}
+
+TEST_CASE("expression assignment reuses storage") {
+  std::mt19937 rng(11);
+  std::string a_str = random_string(200, rng);
+  std::string b_str = random_string(200, rng);
+  bitset a(a_str);
+  const bitset b(b_str);
+
+  auto data = a.begin();
+  a = a & ~b;
+  CHECK(a.begin() == data);
+
+  std::string expected = a_str;
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = (a_str[i] == '1' && b_str[i] == '0') ? '1' : '0';
+  }
+  CHECK_THAT(a, bitset_equals_string(expected));
+
+  a = a.subview(5) | bitset(195, false);
+  CHECK_THAT(a, bitset_equals_string(expected.substr(5)));
+}
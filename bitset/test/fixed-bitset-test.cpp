@@ -0,0 +1,82 @@
+#include "bitset.h"
+#include "fixed-bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+
+namespace {
+
+constexpr fixed_bitset<12> opcode_mask("101100000011");
+
+constexpr fixed_bitset<70> make_pattern() {
+  fixed_bitset<70> res;
+  for (std::size_t i = 0; i < res.size(); i += 3) {
+    res.set(i);
+  }
+  return res;
+}
+
+} // namespace
+
+TEST_CASE("fixed_bitset is usable in constant expressions") {
+  STATIC_REQUIRE(opcode_mask.size() == 12);
+  STATIC_REQUIRE(opcode_mask.count() == 5);
+  STATIC_REQUIRE(opcode_mask.test(0));
+  STATIC_REQUIRE_FALSE(opcode_mask.test(1));
+  STATIC_REQUIRE(opcode_mask[11]);
+  STATIC_REQUIRE(opcode_mask.find_first() == 0);
+
+  STATIC_REQUIRE((~opcode_mask).count() == 7);
+  STATIC_REQUIRE((opcode_mask & ~opcode_mask).none());
+  STATIC_REQUIRE((opcode_mask | ~opcode_mask).all());
+  STATIC_REQUIRE((opcode_mask ^ opcode_mask) == fixed_bitset<12>());
+
+  constexpr auto pattern = make_pattern();
+  STATIC_REQUIRE(pattern.count() == 24);
+  STATIC_REQUIRE(fixed_bitset<70>().set().count() == 70);
+  STATIC_REQUIRE(fixed_bitset<70>().flip().all());
+  STATIC_REQUIRE(fixed_bitset<128>().set().words()[1] == bts::word_ones);
+  STATIC_REQUIRE(fixed_bitset<0>().all());
+}
+
+TEST_CASE("fixed_bitset views") {
+  std::string_view str = "1111011011101000010010111110100001101111111100000110011001001000101110010011010";
+  fixed_bitset<79> bs(str);
+
+  CHECK(bs.to_string() == str);
+  CHECK(fixed_bitset<79>::const_view(bs).count() == bs.count());
+  CHECK(bitset(bs) == bitset(str));
+
+  SECTION("view operations") {
+    bs.subview(3, 70).flip();
+    bitset expected(str);
+    expected.subview(3, 70).flip();
+    CHECK(bitset(bs) == expected);
+  }
+
+  SECTION("operations with bitset") {
+    bitset other(79, true);
+    other.subview(10, 20).reset();
+    fixed_bitset<79>::view(bs) &= other;
+
+    bitset expected(str);
+    expected &= other;
+    CHECK(bitset(bs) == expected);
+  }
+
+  SECTION("references") {
+    bs[1] = false;
+    bs[4] = true;
+    CHECK_FALSE(bs.test(1));
+    CHECK(bs.test(4));
+  }
+
+  SECTION("tail stays clear") {
+    bs.set();
+    CHECK(bs.count() == 79);
+    bs.flip();
+    CHECK(bs.none());
+  }
+}
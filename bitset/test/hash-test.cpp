@@ -0,0 +1,84 @@
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <compare>
+#include <functional>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+TEST_CASE("equality of views with any alignment") {
+  std::mt19937 rng(1);
+  std::string str = random_string(500, rng);
+  std::size_t lhs_offset = GENERATE(0, 3, 64, 67);
+  std::size_t rhs_offset = GENERATE(0, 3, 64, 67);
+  std::size_t size = GENERATE(0, 1, 61, 64, 130, 400);
+  CAPTURE(lhs_offset, rhs_offset, size);
+
+  bitset lhs(std::string(lhs_offset, '1') + str.substr(0, size));
+  bitset rhs(std::string(rhs_offset, '0') + str.substr(0, size));
+  CHECK(lhs.subview(lhs_offset) == rhs.subview(rhs_offset));
+  CHECK((lhs.subview(lhs_offset) <=> rhs.subview(rhs_offset)) == std::strong_ordering::equal);
+  CHECK(std::hash<bitset::const_view>{}(lhs.subview(lhs_offset)) == std::hash<bitset>{}(bitset(str.substr(0, size))));
+
+  for (std::size_t i = 0; i < size; i += 7) {
+    rhs[rhs_offset + i].flip();
+    CHECK(lhs.subview(lhs_offset) != rhs.subview(rhs_offset));
+    CHECK((lhs.subview(lhs_offset) <=> rhs.subview(rhs_offset)) == (str[i] == '1' ? std::strong_ordering::greater
+                                                                                   : std::strong_ordering::less));
+    rhs[rhs_offset + i].flip();
+  }
+}
+
+TEST_CASE("ordering is lexicographic") {
+  std::mt19937 rng(2);
+  std::vector<std::string> strings;
+  for (std::size_t size : {0, 1, 2, 5, 63, 64, 65, 100, 129}) {
+    for (int i = 0; i < 4; ++i) {
+      strings.push_back(random_string(size, rng));
+    }
+  }
+  strings.push_back(std::string(64, '1'));
+  strings.push_back(std::string(65, '1'));
+
+  for (const auto& a : strings) {
+    for (const auto& b : strings) {
+      CAPTURE(a, b);
+      REQUIRE((bitset(a) <=> bitset(b)) == (a <=> b));
+      REQUIRE((bitset(a) < bitset(b)) == (a < b));
+    }
+  }
+}
+
+TEST_CASE("hash") {
+  std::mt19937 rng(3);
+  std::unordered_set<std::string> strings;
+  for (std::size_t size = 0; size < 300; ++size) {
+    strings.insert(random_string(size, rng));
+    strings.insert(std::string(size, '0'));
+  }
+
+  std::unordered_set<std::size_t> hashes;
+  for (const auto& str : strings) {
+    hashes.insert(std::hash<bitset>{}(bitset(str)));
+  }
+  CHECK(hashes.size() == strings.size());
+  CHECK(std::hash<bitset>{}(bitset("1")) != std::hash<bitset>{}(bitset("10")));
+}
+
+TEST_CASE("bitsets as hash map keys") {
+  std::unordered_set<bitset, std::hash<bitset>, std::equal_to<>> signatures;
+  signatures.insert(bitset("10110"));
+  signatures.insert(bitset("0000000000000000000000000000000000000000000000000000000000000000001"));
+  signatures.insert(bitset("10110"));
+  CHECK(signatures.size() == 2);
+
+  bitset haystack("111101101111");
+  CHECK(signatures.contains(haystack.subview(3, 5)));
+  CHECK_FALSE(signatures.contains(haystack.subview(2, 5)));
+}
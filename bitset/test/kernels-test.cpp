@@ -0,0 +1,132 @@
+#include "bitset-kernels.h"
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<bts::word_type> random_words(std::size_t count, std::mt19937_64& rng) {
+  std::vector<bts::word_type> words(count);
+  for (auto& word : words) {
+    word = rng();
+  }
+  return words;
+}
+
+} // namespace
+
+TEST_CASE("every kernel set matches scalar") {
+  const auto& scalar = bts::kernels::scalar();
+  std::size_t count = GENERATE(0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 100, 1000);
+  CAPTURE(count);
+
+  std::mt19937_64 rng(count);
+  auto lhs = random_words(count, rng);
+  auto rhs = random_words(count, rng);
+
+  for (const auto* kernels : bts::kernels::available()) {
+    CAPTURE(kernels->name);
+
+    DYNAMIC_SECTION(kernels->name << " binary operations") {
+      using binary_kernel = void (*)(bts::word_type*, const bts::word_type*, std::size_t);
+      for (auto kernel : {
+               &bts::kernels::kernel_set::and_words,
+               &bts::kernels::kernel_set::or_words,
+               &bts::kernels::kernel_set::xor_words,
+               &bts::kernels::kernel_set::andnot_words,
+           }) {
+        binary_kernel expected_kernel = scalar.*kernel;
+        binary_kernel actual_kernel = kernels->*kernel;
+
+        auto expected = lhs;
+        auto actual = lhs;
+        expected_kernel(expected.data(), rhs.data(), count);
+        actual_kernel(actual.data(), rhs.data(), count);
+        REQUIRE(actual == expected);
+      }
+    }
+
+    DYNAMIC_SECTION(kernels->name << " not") {
+      auto expected = lhs;
+      auto actual = lhs;
+      scalar.not_words(expected.data(), count);
+      kernels->not_words(actual.data(), count);
+      REQUIRE(actual == expected);
+    }
+
+    DYNAMIC_SECTION(kernels->name << " popcount") {
+      REQUIRE(kernels->popcount(lhs.data(), count) == scalar.popcount(lhs.data(), count));
+    }
+
+    DYNAMIC_SECTION(kernels->name << " all and any") {
+      std::vector<bts::word_type> ones(count, bts::word_ones);
+      std::vector<bts::word_type> zeros(count, bts::word_zeros);
+      REQUIRE(kernels->all(ones.data(), count));
+      REQUIRE_FALSE(kernels->any(zeros.data(), count));
+      REQUIRE(kernels->all(lhs.data(), count) == scalar.all(lhs.data(), count));
+      REQUIRE(kernels->any(lhs.data(), count) == scalar.any(lhs.data(), count));
+
+      for (std::size_t i = 0; i < count; ++i) {
+        ones[i] ^= bts::word_type(1) << (i % bts::word_size);
+        zeros[i] = ones[i] ^ bts::word_ones;
+        REQUIRE_FALSE(kernels->all(ones.data(), count));
+        REQUIRE(kernels->any(zeros.data(), count));
+        ones[i] = bts::word_ones;
+        zeros[i] = bts::word_zeros;
+      }
+    }
+
+    DYNAMIC_SECTION(kernels->name << " equal") {
+      auto copy = lhs;
+      REQUIRE(kernels->equal(lhs.data(), copy.data(), count));
+      for (std::size_t i = 0; i < count; ++i) {
+        copy[i] ^= bts::word_type(1) << (i % bts::word_size);
+        REQUIRE_FALSE(kernels->equal(lhs.data(), copy.data(), count));
+        copy[i] = lhs[i];
+      }
+    }
+  }
+}
+
+TEST_CASE("active kernel set is available") {
+  const auto& active = bts::kernels::active();
+  auto available = bts::kernels::available();
+
+  REQUIRE_FALSE(available.empty());
+  CHECK(available.front() == &bts::kernels::scalar());
+  CHECK(std::find(available.begin(), available.end(), &active) != available.end());
+}
+
+TEST_CASE("bulk operations on large bitsets") {
+  std::mt19937_64 rng(42);
+  std::size_t size = GENERATE(1000, 1024, 4099);
+  CAPTURE(size);
+
+  std::string lhs_str(size, '0');
+  std::string rhs_str(size, '0');
+  for (std::size_t i = 0; i < size; ++i) {
+    lhs_str[i] = rng() % 2 == 0 ? '0' : '1';
+    rhs_str[i] = rng() % 2 == 0 ? '0' : '1';
+  }
+  bitset lhs(lhs_str);
+  const bitset rhs(rhs_str);
+
+  std::string and_str = lhs_str;
+  for (std::size_t i = 0; i < size; ++i) {
+    and_str[i] = (lhs_str[i] == '1' && rhs_str[i] == '1') ? '1' : '0';
+  }
+
+  CHECK(lhs.count() == std::ranges::count(lhs_str, '1'));
+  CHECK((lhs & rhs).to_string() == and_str);
+  CHECK(lhs == bitset(lhs_str));
+  CHECK(lhs != rhs);
+
+  lhs.flip();
+  CHECK(lhs.count() == size - std::ranges::count(lhs_str, '1'));
+}
@@ -412,3 +412,120 @@ TEST_CASE("chained view operations") {
   CHECK(bs_1 == bitset("0010000001"));
   CHECK(bs_2 == bitset("1110010101"));
 }
+
+TEST_CASE("word-aligned view operations") {
+  std::string lhs_str = "11110110111010000100101111101000011011111111000001100110010010001011100100110101";
+  std::string rhs_str = "00011110011010000111001101110001000001000010001001011110010010110111011110111111";
+  lhs_str += lhs_str;
+  rhs_str += rhs_str;
+
+  auto [offset, count] = GENERATE(table<std::size_t, std::size_t>({
+      {0, 160},
+      {0, 128},
+      {64, 96},
+      {64, 70},
+      {0, 30},
+  }));
+  CAPTURE(offset, count);
+
+  bitset lhs(lhs_str);
+  const bitset rhs(rhs_str);
+  std::string expected = lhs_str;
+
+  auto apply = [&](auto op) {
+    for (std::size_t i = offset; i < offset + count; ++i) {
+      expected[i] = op(lhs_str[i] == '1', rhs_str[i] == '1') ? '1' : '0';
+    }
+  };
+
+  SECTION("bitwise and") {
+    lhs.subview(offset, count) &= rhs.subview(offset, count);
+    apply([](bool a, bool b) { return a && b; });
+    CHECK_THAT(lhs, bitset_equals_string(expected));
+  }
+
+  SECTION("bitwise or") {
+    lhs.subview(offset, count) |= rhs.subview(offset, count);
+    apply([](bool a, bool b) { return a || b; });
+    CHECK_THAT(lhs, bitset_equals_string(expected));
+  }
+
+  SECTION("bitwise xor") {
+    lhs.subview(offset, count) ^= rhs.subview(offset, count);
+    apply([](bool a, bool b) { return a != b; });
+    CHECK_THAT(lhs, bitset_equals_string(expected));
+  }
+
+  SECTION("flip") {
+    lhs.subview(offset, count).flip();
+    apply([](bool a, bool) { return !a; });
+    CHECK_THAT(lhs, bitset_equals_string(expected));
+  }
+
+  SECTION("set") {
+    lhs.subview(offset, count).set();
+    apply([](bool, bool) { return true; });
+    CHECK_THAT(lhs, bitset_equals_string(expected));
+  }
+
+  SECTION("reset") {
+    lhs.subview(offset, count).reset();
+    apply([](bool, bool) { return false; });
+    CHECK_THAT(lhs, bitset_equals_string(expected));
+  }
+
+  SECTION("count") {
+    std::size_t ones = std::count(lhs_str.begin() + offset, lhs_str.begin() + offset + count, '1');
+    CHECK(lhs.subview(offset, count).count() == ones);
+    CHECK(lhs.subview(offset, count).any() == (ones != 0));
+    CHECK(lhs.subview(offset, count).all() == (ones == count));
+  }
+}
+
+TEST_CASE("in-place shifts") {
+  std::string str = "11110110111010000100101111101000011011111111000001100110010010001011100100110101";
+  str += str;
+  std::size_t shift_count = GENERATE(0, 1, 5, 63, 64, 65, 100, 159, 160, 190);
+  CAPTURE(shift_count);
+
+  auto shifted_left = [&](std::string_view s) {
+    std::size_t n = std::min(shift_count, s.size());
+    return std::string(s.substr(n)) + std::string(n, '0');
+  };
+  auto shifted_right = [&](std::string_view s) {
+    std::size_t n = std::min(shift_count, s.size());
+    return std::string(n, '0') + std::string(s.substr(0, s.size() - n));
+  };
+
+  SECTION("bitset") {
+    bitset bs(str);
+    auto data = bs.begin();
+
+    bs.shift_left_inplace(shift_count);
+    CHECK_THAT(bs, bitset_equals_string(shifted_left(str)));
+    CHECK(bs.begin() == data);
+
+    bs = str;
+    bs.shift_right_inplace(shift_count);
+    CHECK_THAT(bs, bitset_equals_string(shifted_right(str)));
+  }
+
+  SECTION("view") {
+    auto [offset, count] = GENERATE(table<std::size_t, std::size_t>({
+        {0, 160},
+        {64, 70},
+        {3, 150},
+        {17, 40},
+    }));
+    CAPTURE(offset, count);
+    std::string_view sub = std::string_view(str).substr(offset, count);
+
+    bitset bs(str);
+    bs.subview(offset, count).shift_left_inplace(shift_count);
+    CHECK_THAT(bs, bitset_equals_string(str.substr(0, offset) + shifted_left(sub) + str.substr(offset + count)));
+
+    bs = str;
+    bs.subview(offset, count).shift_right_inplace(shift_count);
+    CHECK_THAT(bs, bitset_equals_string(str.substr(0, offset) + shifted_right(sub) + str.substr(offset + count)));
+  }
+}
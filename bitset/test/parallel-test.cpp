@@ -0,0 +1,65 @@
+#include "bitset-parallel.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <random>
+#include <string>
+
+TEST_CASE("parallel operations match serial ones") {
+  std::size_t threads = GENERATE(1, 2, 3, 8);
+  std::size_t size = GENERATE(0, 1, 100, 1000, 20000);
+  std::size_t dst_offset = GENERATE(0, 5);
+  std::size_t src_offset = GENERATE(0, 64, 77);
+  CAPTURE(threads, size, dst_offset, src_offset);
+
+  const bts::parallel::options opts{threads, 0};
+  std::mt19937 rng(static_cast<unsigned>(size + threads));
+  std::string lhs_str = random_string(size + dst_offset + 10, rng);
+  const bitset rhs(random_string(size + src_offset, rng));
+  auto src = rhs.subview(src_offset, size);
+
+  bitset lhs(lhs_str);
+  bitset expected(lhs_str);
+
+  SECTION("and") {
+    bts::parallel::and_assign(lhs.subview(dst_offset, size), src, opts);
+    expected.subview(dst_offset, size) &= src;
+    CHECK(lhs == expected);
+  }
+
+  SECTION("or") {
+    bts::parallel::or_assign(lhs.subview(dst_offset, size), src, opts);
+    expected.subview(dst_offset, size) |= src;
+    CHECK(lhs == expected);
+  }
+
+  SECTION("xor") {
+    bts::parallel::xor_assign(lhs.subview(dst_offset, size), src, opts);
+    expected.subview(dst_offset, size) ^= src;
+    CHECK(lhs == expected);
+  }
+
+  SECTION("count") {
+    CHECK(bts::parallel::count(lhs.subview(dst_offset, size), opts) == lhs.subview(dst_offset, size).count());
+  }
+
+  SECTION("equal") {
+    bitset copy(src);
+    CHECK(bts::parallel::equal(copy, src, opts));
+    if (size > 0) {
+      copy[size * 2 / 3].flip();
+      CHECK_FALSE(bts::parallel::equal(copy, src, opts));
+    }
+    CHECK_FALSE(bts::parallel::equal(lhs, src, opts));
+  }
+}
+
+TEST_CASE("parallel operations stay serial below the threshold") {
+  bitset bs(1000, true);
+  CHECK(bts::parallel::count(bs) == 1000);
+  bts::parallel::xor_assign(bs, bitset(1000, true));
+  CHECK_FALSE(bs.any());
+}
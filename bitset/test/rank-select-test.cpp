@@ -0,0 +1,76 @@
+#include "bitset.h"
+#include "rank-select.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string random_string(std::size_t size, unsigned percent, std::mt19937& rng) {
+  std::string res(size, '0');
+  for (auto& c : res) {
+    c = rng() % 100 < percent ? '1' : '0';
+  }
+  return res;
+}
+
+} // namespace
+
+TEST_CASE("rank and select") {
+  std::size_t size = GENERATE(0, 1, 63, 64, 511, 512, 513, 70000, 200000);
+  unsigned percent = GENERATE(0u, 1u, 50u, 100u);
+  std::size_t offset = GENERATE(0, 3);
+  CAPTURE(size, percent, offset);
+
+  std::mt19937 rng(static_cast<unsigned>(size) + percent);
+  std::string str = random_string(size + offset, percent, rng);
+  str += "111";
+  const bitset bs(str);
+  const rank_select_index index(bs.subview(offset, size));
+
+  std::vector<std::size_t> ranks(size + 1, 0);
+  std::vector<std::size_t> positions;
+  for (std::size_t i = 0; i < size; ++i) {
+    ranks[i + 1] = ranks[i] + (str[offset + i] == '1' ? 1 : 0);
+    if (str[offset + i] == '1') {
+      positions.push_back(i);
+    }
+  }
+
+  REQUIRE(index.size() == size);
+  REQUIRE(index.count() == positions.size());
+  for (std::size_t i = 0; i <= size; i += 1 + i / 64) {
+    REQUIRE(index.rank1(i) == ranks[i]);
+    REQUIRE(index.rank0(i) == i - ranks[i]);
+  }
+  REQUIRE(index.rank1(size) == positions.size());
+  for (std::size_t k = 0; k < positions.size(); k += 1 + k / 64) {
+    REQUIRE(index.select1(k) == positions[k]);
+  }
+  CHECK(index.select1(positions.size()) == rank_select_index::npos);
+}
+
+TEST_CASE("rank and select index after changes") {
+  std::mt19937 rng(3);
+  bitset bs(random_string(300000, 30, rng));
+  rank_select_index index(bs);
+
+  bs[250000] = !bs[250000];
+  bs.subview(140000, 1000).set();
+  index.update(140000);
+  CHECK(index.count() == bs.count());
+  CHECK(index.rank1(200000) == bs.subview(0, 200000).count());
+  CHECK(index.select1(index.rank1(140500)) == 140500);
+
+  bs.resize(400000, true);
+  index.rebuild(bs);
+  CHECK(index.count() == bs.count());
+  CHECK(index.rank1(350000) == bs.subview(0, 350000).count());
+  CHECK(index.select1(index.count() - 1) == 399999);
+
+  CHECK(index.memory_usage() * 100 < bs.size() / 8 * 4);
+}
@@ -0,0 +1,93 @@
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <random>
+#include <ranges>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<bitset_run> runs_of(std::string_view str) {
+  std::vector<bitset_run> res;
+  for (std::size_t i = 0; i < str.size();) {
+    if (str[i] == '0') {
+      ++i;
+      continue;
+    }
+    std::size_t end = str.find('0', i);
+    end = end == std::string_view::npos ? str.size() : end;
+    res.push_back({i, end});
+    i = end;
+  }
+  return res;
+}
+
+// Alternating runs of ones and zeros with random lengths up to `max_length`.
+std::string runs_string(std::size_t size, std::size_t max_length, std::mt19937& rng) {
+  std::string res;
+  char c = rng() % 2 == 0 ? '0' : '1';
+  while (res.size() < size) {
+    res.append(std::min(size - res.size(), 1 + rng() % max_length), c);
+    c = c == '0' ? '1' : '0';
+  }
+  return res;
+}
+
+} // namespace
+
+TEST_CASE("runs") {
+  std::size_t size = GENERATE(0, 1, 64, 65, 300, 5000);
+  std::size_t max_length = GENERATE(1, 3, 70, 1000);
+  std::size_t offset = GENERATE(0, 9);
+  CAPTURE(size, max_length, offset);
+
+  std::mt19937 rng(static_cast<unsigned>(size + max_length));
+  std::string str = std::string(offset, '1') + runs_string(size, max_length, rng);
+  const bitset bs(str);
+  bitset::const_view view = bs.subview(offset);
+  auto expected = runs_of(std::string_view(str).substr(offset));
+
+  SECTION("for_each_run") {
+    std::vector<bitset_run> visited;
+    view.for_each_run([&](std::size_t begin, std::size_t end) { visited.push_back({begin, end}); });
+    CHECK(visited == expected);
+  }
+
+  SECTION("runs") {
+    std::vector<bitset_run> found;
+    std::ranges::copy(view.runs(), std::back_inserter(found));
+    CHECK(found == expected);
+  }
+
+  SECTION("building from runs") {
+    bitset built(size, expected);
+    CHECK(built == view);
+  }
+}
+
+TEST_CASE("runs of full and empty bitsets") {
+  std::size_t size = GENERATE(1, 64, 128, 1000);
+  CAPTURE(size);
+
+  CHECK(std::ranges::empty(bitset(size, false).runs()));
+
+  std::vector<bitset_run> runs;
+  bitset(size, true).for_each_run([&](std::size_t begin, std::size_t end) { runs.push_back({begin, end}); });
+  CHECK(runs == std::vector<bitset_run>{{0, size}});
+  CHECK(*bitset(size, true).runs().begin() == bitset_run{0, size});
+}
+
+TEST_CASE("set_runs with overlapping runs") {
+  bitset bs(200, false);
+  std::vector<bitset_run> runs = {{150, 190}, {10, 80}, {60, 130}, {5, 5}};
+  bitset::view(bs).set_runs(runs);
+
+  std::string expected(200, '0');
+  expected.replace(10, 120, 120, '1');
+  expected.replace(150, 40, 40, '1');
+  CHECK_THAT(bs, bitset_equals_string(expected));
+}
@@ -0,0 +1,102 @@
+#include "bitset.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<std::size_t> positions_of(std::string_view str, char c) {
+  std::vector<std::size_t> res;
+  for (std::size_t i = 0; i < str.size(); ++i) {
+    if (str[i] == c) {
+      res.push_back(i);
+    }
+  }
+  return res;
+}
+
+std::string sparse_string(std::size_t size, std::size_t ones, std::mt19937& rng) {
+  std::string res(size, '0');
+  for (std::size_t i = 0; i < ones && size > 0; ++i) {
+    res[rng() % size] = '1';
+  }
+  return res;
+}
+
+} // namespace
+
+TEST_CASE("find on empty bitset") {
+  bitset bs;
+
+  CHECK(bs.find_first() == bitset::npos);
+  CHECK(bs.find_last() == bitset::npos);
+  CHECK(bs.find_first_zero() == bitset::npos);
+  CHECK(bs.find_next(0) == bitset::npos);
+
+  bool visited = false;
+  bs.for_each_set([&](std::size_t) { visited = true; });
+  CHECK_FALSE(visited);
+}
+
+TEST_CASE("find without matches") {
+  std::size_t size = GENERATE(1, 63, 64, 65, 300);
+  CAPTURE(size);
+
+  CHECK(bitset(size, false).find_first() == bitset::npos);
+  CHECK(bitset(size, false).find_last() == bitset::npos);
+  CHECK(bitset(size, true).find_first_zero() == bitset::npos);
+  CHECK(bitset(size, true).find_next(size - 1) == bitset::npos);
+}
+
+TEST_CASE("find set bits") {
+  std::size_t size = GENERATE(1, 7, 64, 65, 200, 1000);
+  std::size_t ones = GENERATE(1, 3, 40);
+  CAPTURE(size, ones);
+
+  std::mt19937 rng(size * 31 + ones);
+  std::string str = sparse_string(size, ones, rng);
+  auto expected = positions_of(str, '1');
+  auto expected_zeros = positions_of(str, '0');
+  const bitset bs(str);
+
+  SECTION("bitset") {
+    CHECK(bs.find_first() == expected.front());
+    CHECK(bs.find_last() == expected.back());
+    CHECK(bs.find_first_zero() == (expected_zeros.empty() ? bitset::npos : expected_zeros.front()));
+
+    std::vector<std::size_t> found;
+    for (std::size_t i = bs.find_first(); i != bitset::npos; i = bs.find_next(i)) {
+      found.push_back(i);
+    }
+    CHECK(found == expected);
+
+    std::vector<std::size_t> visited;
+    bs.for_each_set([&](std::size_t i) { visited.push_back(i); });
+    CHECK(visited == expected);
+  }
+
+  SECTION("view") {
+    std::size_t offset = GENERATE(0, 1, 5);
+    CAPTURE(offset);
+    if (offset >= size) {
+      return;
+    }
+
+    bitset::const_view view = bs.subview(offset);
+    std::string_view sub = std::string_view(str).substr(offset);
+    auto sub_expected = positions_of(sub, '1');
+    auto sub_zeros = positions_of(sub, '0');
+
+    CHECK(view.find_first() == (sub_expected.empty() ? bitset::npos : sub_expected.front()));
+    CHECK(view.find_last() == (sub_expected.empty() ? bitset::npos : sub_expected.back()));
+    CHECK(view.find_first_zero() == (sub_zeros.empty() ? bitset::npos : sub_zeros.front()));
+
+    std::vector<std::size_t> visited;
+    view.for_each_set([&](std::size_t i) { visited.push_back(i); });
+    CHECK(visited == sub_expected);
+  }
+}
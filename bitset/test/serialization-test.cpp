@@ -0,0 +1,139 @@
+#include "bitset-serialization.h"
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string serialized(const bitset::const_view& bs) {
+  std::ostringstream out;
+  serialize(out, bs);
+  return out.str();
+}
+
+// Copies serialized data to word-aligned storage, like a memory-mapped file.
+std::vector<bts::word_type> aligned_copy(const std::string& data) {
+  std::vector<bts::word_type> res((data.size() + sizeof(bts::word_type) - 1) / sizeof(bts::word_type));
+  std::memcpy(res.data(), data.data(), data.size());
+  return res;
+}
+
+std::span<const std::byte> bytes_of(const std::vector<bts::word_type>& words, std::size_t size) {
+  return std::as_bytes(std::span(words)).first(size);
+}
+
+} // namespace
+
+TEST_CASE("serialization round trip") {
+  std::size_t size = GENERATE(0, 1, 63, 64, 65, 1000, 70000);
+  std::size_t offset = GENERATE(0, 5);
+  CAPTURE(size, offset);
+
+  std::mt19937 rng(size);
+  std::string str = random_string(size + offset, rng);
+  const bitset source(str);
+  auto view = source.subview(offset);
+
+  std::string data = serialized(view);
+  CHECK(data.size() == serialized_size(size));
+
+  std::istringstream in(data);
+  CHECK_THAT(deserialize(in), bitset_equals_string(str.substr(offset)));
+
+  auto words = aligned_copy(data);
+  auto mapped = view_serialized(bytes_of(words, data.size()), true);
+  CHECK(mapped.size() == size);
+  CHECK(mapped == view);
+}
+
+TEST_CASE("serialized view does not copy") {
+  const bitset source("1011001110001111000011111");
+  std::string data = serialized(source);
+  auto words = aligned_copy(data);
+
+  auto mapped = view_serialized(bytes_of(words, data.size()));
+  CHECK(mapped.count() == source.count());
+
+  words[bts::serialization::header_size / sizeof(bts::word_type)] ^= bts::word_type(1) << 63;
+  CHECK_FALSE(mapped[0]);
+}
+
+TEST_CASE("malformed serialized data") {
+  std::mt19937 rng(1);
+  const bitset source(random_string(500, rng));
+  std::string data = serialized(source);
+
+  auto check_rejected = [](const std::string& bad) {
+    std::istringstream in(bad);
+    CHECK_THROWS_AS(deserialize(in), bitset_format_error);
+    auto words = aligned_copy(bad);
+    CHECK_THROWS_AS(view_serialized(bytes_of(words, bad.size()), true), bitset_format_error);
+  };
+
+  SECTION("bad magic") {
+    data[0] = 'X';
+    check_rejected(data);
+  }
+
+  SECTION("unsupported version") {
+    data[4] = 7;
+    check_rejected(data);
+  }
+
+  SECTION("truncated header") {
+    check_rejected(data.substr(0, 10));
+  }
+
+  SECTION("truncated data") {
+    check_rejected(data.substr(0, data.size() - 1));
+  }
+
+  SECTION("corrupted data") {
+    data[bts::serialization::header_size + 3] ^= 0x10;
+    check_rejected(data);
+  }
+
+  SECTION("size does not match data") {
+    data[8] = static_cast<char>(data[8] - 1);
+    check_rejected(data);
+  }
+
+  SECTION("unaligned region") {
+    std::vector<bts::word_type> words = aligned_copy(" " + data);
+    auto region = std::as_bytes(std::span(words)).subspan(1, data.size());
+    CHECK_THROWS_AS(view_serialized(region), bitset_format_error);
+  }
+}
+
+TEST_CASE("deserializing the other byte order") {
+  const bitset source("110100000000000000000000000000000000000000000000000000000000000000001011");
+  std::string data = serialized(source);
+
+  auto reverse = [&data](std::size_t offset, std::size_t size) {
+    std::reverse(data.begin() + offset, data.begin() + offset + size);
+  };
+  reverse(4, 2);
+  reverse(6, 2);
+  reverse(8, 8);
+  reverse(16, 8);
+  for (std::size_t offset = bts::serialization::header_size; offset < data.size(); offset += 8) {
+    reverse(offset, 8);
+  }
+
+  std::istringstream in(data);
+  CHECK(deserialize(in) == source);
+
+  auto words = aligned_copy(data);
+  CHECK_THROWS_AS(view_serialized(bytes_of(words, data.size())), bitset_format_error);
+}
@@ -7,6 +7,14 @@ std::vector<bool> string_to_bools(std::string_view str) {
   return {view.begin(), view.end()};
 }
 
+std::string random_string(std::size_t size, std::mt19937& rng) {
+  std::string res(size, '0');
+  for (auto& c : res) {
+    c = rng() % 2 == 0 ? '0' : '1';
+  }
+  return res;
+}
+
 bitset_equals_string::bitset_equals_string(std::string_view expected)
     : _expected(expected) {}
 
@@ -0,0 +1,117 @@
+#include "bitset.h"
+#include "test-helpers.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <ranges>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Words of `str` as `bitset_view::words` yields them, the tail padded with zeros.
+std::vector<bts::word_type> words_of(std::string_view str) {
+  std::vector<bts::word_type> res;
+  for (std::size_t i = 0; i < str.size(); i += bts::word_size) {
+    std::string word(str.substr(i, bts::word_size));
+    word.resize(bts::word_size, '0');
+    res.push_back(bts::stow(word));
+  }
+  return res;
+}
+
+} // namespace
+
+TEST_CASE("word range traits") {
+  STATIC_CHECK(std::ranges::random_access_range<bitset::const_view::word_range>);
+  STATIC_CHECK(std::ranges::random_access_range<bitset::view::word_range>);
+  STATIC_CHECK(std::ranges::sized_range<bitset::view::word_range>);
+  STATIC_CHECK(std::is_same_v<std::ranges::range_value_t<bitset::view::word_range>, bts::word_type>);
+  STATIC_CHECK(std::is_same_v<std::ranges::range_reference_t<bitset::const_view::word_range>, bts::word_type>);
+  STATIC_CHECK(std::output_iterator<bitset::view::word_iterator, bts::word_type>);
+}
+
+TEST_CASE("word range") {
+  std::size_t size = GENERATE(0, 1, 63, 64, 65, 200, 1000);
+  std::size_t offset = GENERATE(0, 1, 37, 64, 100);
+  CAPTURE(size, offset);
+
+  std::mt19937 rng(static_cast<unsigned>(size * 7 + offset));
+  std::string str = random_string(offset + size + 11, rng);
+  bitset bs(str);
+  bitset::view view = bs.subview(offset, size);
+  std::string_view sub = std::string_view(str).substr(offset, size);
+
+  SECTION("reading") {
+    auto expected = words_of(sub);
+    CHECK(std::ranges::equal(bitset::const_view(view).words(), expected));
+    CHECK(std::ranges::equal(view.words(), expected));
+    CHECK(std::ranges::size(view.words()) == expected.size());
+    if (offset == 0) {
+      CHECK(std::ranges::equal(bitset(sub).words(), expected));
+    }
+  }
+
+  SECTION("writing") {
+    std::string words_str = random_string(size, rng);
+    auto words = words_of(words_str);
+    std::ranges::copy(words, view.words().begin());
+
+    std::string expected = str;
+    expected.replace(offset, size, words_str);
+    CHECK_THAT(bs, bitset_equals_string(expected));
+  }
+
+  SECTION("compound assignment") {
+    std::string mask_str = random_string(size, rng);
+    auto mask = words_of(mask_str);
+    auto words = view.words();
+    for (std::size_t i = 0; i < mask.size(); ++i) {
+      words[static_cast<std::ptrdiff_t>(i)] ^= mask[i];
+    }
+
+    std::string expected = str;
+    for (std::size_t i = 0; i < size; ++i) {
+      expected[offset + i] = (str[offset + i] != mask_str[i]) ? '1' : '0';
+    }
+    CHECK_THAT(bs, bitset_equals_string(expected));
+  }
+
+  SECTION("bits past the end of the last word are ignored") {
+    if (size != 0) {
+      auto last = view.words()[static_cast<std::ptrdiff_t>(view.words().size() - 1)];
+      const std::size_t tail = size - (view.words().size() - 1) * bts::word_size;
+      std::string expected = str;
+
+      last = bts::word_ones;
+      std::fill_n(expected.begin() + static_cast<std::ptrdiff_t>(offset + size - tail), tail, '1');
+      CHECK_THAT(bs, bitset_equals_string(expected));
+
+      last ^= bts::word_ones;
+      std::fill_n(expected.begin() + static_cast<std::ptrdiff_t>(offset + size - tail), tail, '0');
+      CHECK_THAT(bs, bitset_equals_string(expected));
+
+      last |= bts::word_ones;
+      std::fill_n(expected.begin() + static_cast<std::ptrdiff_t>(offset + size - tail), tail, '1');
+      CHECK_THAT(bs, bitset_equals_string(expected));
+
+      bs.subview(offset, size).flip();
+      last &= bts::word_ones;
+      for (std::size_t i = offset; i < offset + size; ++i) {
+        expected[i] = expected[i] == '1' ? '0' : '1';
+      }
+      CHECK_THAT(bs, bitset_equals_string(expected));
+    }
+  }
+
+  SECTION("copying between views") {
+    bitset other(random_string(size + 3, rng));
+    bitset::view target = other.subview(3);
+    std::ranges::copy(view.words(), target.words().begin());
+    CHECK(target == bitset::const_view(view));
+  }
+}